@@ -4,6 +4,8 @@
  * This file exports the <code>Grid</code> class, which offers a
  * convenient abstraction for representing a two-dimensional array.
  *
+ * @version 2026/10/16
+ * - added swap method for constant-time double buffering
  * @version 2018/03/12
  * - added overloads that accept GridLocation: get, inBounds, locations, set, operator []
  * @version 2018/03/10
@@ -54,6 +56,7 @@
 #include <iostream>
 #include <string>
 #include <sstream>
+#include <utility>
 
 #define INTERNAL_INCLUDE 1
 #include "collections.h"
@@ -308,6 +311,16 @@ public:
      */
     int size() const;
 
+    /*
+     * Method: swap
+     * Usage: grid.swap(grid2);
+     * ------------------------
+     * Exchanges the contents of this grid and <code>grid2</code>, including
+     * their dimensions.  No elements are copied, so this takes constant time
+     * regardless of the size of either grid.
+     */
+    void swap(Grid& grid2);
+
     /*
      * Method: toString
      * Usage: string str = grid.toString();
@@ -921,6 +934,15 @@ int Grid<ValueType>::size() const {
     return nRows * nCols;
 }
 
+template <typename ValueType>
+void Grid<ValueType>::swap(Grid& grid2) {
+    std::swap(elements, grid2.elements);
+    std::swap(nRows, grid2.nRows);
+    std::swap(nCols, grid2.nCols);
+    m_version++;
+    grid2.m_version++;
+}
+
 template <typename ValueType>
 std::string Grid<ValueType>::toString() const {
     std::ostringstream os;
@@ -0,0 +1,178 @@
+/**
+ * File: life-active.cpp
+ * ---------------------
+ * Implements the active-tile Life engine.  Each step reads the current
+ * plane, records every cell whose age will change in a change list, and
+ * only then applies the list, so tiles that are skipped never need to be
+ * copied.  A cell whose neighborhood did not change cannot change either,
+ * which is what makes skipping quiet tiles exact.
+ */
+
+#include <algorithm>  // for min, max
+using namespace std;
+
+#include "life-constants.h"  // for kMaxAge
+#include "life-active.h"
+
+ActiveLifeEngine::ActiveLifeEngine()
+        : rows(0), cols(0), rowStride(2), tileRows(0), tileCols(0), countingAges(false), rule(kConwayRule) {
+    clearStats(counts);
+}
+
+string ActiveLifeEngine::name() const {
+    return "active";
+}
+
+void ActiveLifeEngine::load(const Grid<int>& board) {
+    rows = board.numRows();
+    cols = board.numCols();
+    rowStride = cols + 2;
+    ages.assign(static_cast<size_t>(rows + 2) * rowStride, 0);
+    outline.reset(rows, cols);
+    clearStats(counts);
+    countingAges = false;
+    for (int r = 0; r < rows; r++) {
+        for (int c = 0; c < cols; c++) {
+            ages[indexOf(r, c)] = static_cast<uint8_t>(max(0, min(board.get(r, c), kMaxAge)));
+            if (ages[indexOf(r, c)] > 0) {
+                outline.add(r, c);
+            }
+        }
+    }
+
+    tileRows = (rows + kTileSize - 1) / kTileSize;
+    tileCols = (cols + kTileSize - 1) / kTileSize;
+    active.clear();
+    scheduled.assign(static_cast<size_t>(tileRows) * tileCols, false);
+    for (int tr = 0; tr < tileRows; tr++) {
+        for (int tc = 0; tc < tileCols; tc++) {
+            schedule(tr, tc);
+        }
+    }
+}
+
+bool ActiveLifeEngine::step() {
+    vector<int> visiting;
+    visiting.swap(active);
+    for (size_t t = 0; t < visiting.size(); t++) {
+        scheduled[visiting[t]] = false;
+    }
+    changes.clear();
+    counts.births = 0;
+    counts.deaths = 0;
+
+    for (size_t t = 0; t < visiting.size(); t++) {
+        int tileRow = visiting[t] / tileCols;
+        int tileCol = visiting[t] % tileCols;
+        int top = tileRow * kTileSize;
+        int left = tileCol * kTileSize;
+        int bottom = min(top + kTileSize, rows) - 1;
+        int right = min(left + kTileSize, cols) - 1;
+        bool changed = false;
+        bool north = false, south = false, west = false, east = false;
+
+        for (int r = top; r <= bottom; r++) {
+            const uint8_t* up = &ages[indexOf(r - 1, 0)];
+            const uint8_t* mid = &ages[indexOf(r, 0)];
+            const uint8_t* down = &ages[indexOf(r + 1, 0)];
+            for (int c = left; c <= right; c++) {
+                int neighbors = (up[c - 1] > 0) + (up[c] > 0) + (up[c + 1] > 0)
+                        + (mid[c - 1] > 0) + (mid[c + 1] > 0)
+                        + (down[c - 1] > 0) + (down[c] > 0) + (down[c + 1] > 0);
+                int age = mid[c];
+                int next = nextAge(rule, age, neighbors);
+                if (next != age) {
+                    Change change = { indexOf(r, c), static_cast<uint8_t>(next) };
+                    changes.push_back(change);
+                    if (age == 0) {
+                        outline.add(r, c);
+                        counts.births++;
+                    } else if (next == 0) {
+                        outline.remove(r, c);
+                        counts.deaths++;
+                    }
+                    changed = true;
+                    north |= (r == top);
+                    south |= (r == bottom);
+                    west |= (c == left);
+                    east |= (c == right);
+                }
+            }
+        }
+
+        if (changed) {
+            schedule(tileRow, tileCol);
+            for (int dr = -1; dr <= 1; dr++) {
+                for (int dc = -1; dc <= 1; dc++) {
+                    bool touchesRow = (dr == 0) || (dr < 0 ? north : south);
+                    bool touchesCol = (dc == 0) || (dc < 0 ? west : east);
+                    if ((dr != 0 || dc != 0) && touchesRow && touchesCol) {
+                        schedule(tileRow + dr, tileCol + dc);
+                    }
+                }
+            }
+        }
+    }
+
+    for (size_t i = 0; i < changes.size(); i++) {
+        if (countingAges) {
+            counts.ages[ages[changes[i].index]]--;
+            counts.ages[changes[i].age]++;
+        }
+        ages[changes[i].index] = changes[i].age;
+    }
+    return !changes.empty();
+}
+
+void ActiveLifeEngine::stats(LifeStats& stats) const {
+    if (!countingAges) {
+        for (int age = 0; age <= kMaxAge; age++) {
+            counts.ages[age] = 0;
+        }
+        for (int r = 0; r < rows; r++) {
+            for (int c = 0; c < cols; c++) {
+                counts.ages[ages[indexOf(r, c)]]++;
+            }
+        }
+        countingAges = true;
+    }
+    stats = counts;
+    stats.population = outline.population();
+}
+
+/**
+ * A tile that was quiet under the old rule may not be under the new one,
+ * so every tile is visited again.
+ */
+bool ActiveLifeEngine::setRule(const LifeRule& newRule) {
+    rule = newRule;
+    for (int tr = 0; tr < tileRows; tr++) {
+        for (int tc = 0; tc < tileCols; tc++) {
+            schedule(tr, tc);
+        }
+    }
+    return true;
+}
+
+int ActiveLifeEngine::ageAt(int row, int col) const {
+    return ages[indexOf(row, col)];
+}
+
+size_t ActiveLifeEngine::indexOf(int row, int col) const {
+    return static_cast<size_t>(row + 1) * rowStride + (col + 1);
+}
+
+/**
+ * Adds the tile to the next step's work list unless it is off the board
+ * or already on the list.
+ */
+void ActiveLifeEngine::schedule(int tileRow, int tileCol) {
+    if (tileRow < 0 || tileRow >= tileRows || tileCol < 0 || tileCol >= tileCols) {
+        return;
+    }
+    int tile = tileRow * tileCols + tileCol;
+    if (!scheduled[tile]) {
+        scheduled[tile] = true;
+        active.push_back(tile);
+    }
+}
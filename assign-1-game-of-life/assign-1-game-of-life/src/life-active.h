@@ -0,0 +1,80 @@
+/**
+ * File: life-active.h
+ * -------------------
+ * Defines a Life engine that only revisits the parts of the board where
+ * something happened last generation.  The board is split into square
+ * tiles, and a tile is stepped only if one of its own cells changed or a
+ * change touched the edge it shares with a neighboring tile.  Once a
+ * colony settles into still lifes and oscillators, the cost of a
+ * generation follows the amount of activity rather than the board area.
+ */
+
+#pragma once
+#include <cstdint>   // for uint8_t
+#include <string>    // for std::string
+#include <vector>    // for std::vector
+#include "grid.h"    // for Grid
+
+#include "life-engine.h"
+#include "life-shape.h"   // for ShapeTracker
+
+class ActiveLifeEngine : public LifeEngine {
+public:
+/**
+ * Constructs an empty engine.  Call load before stepping.
+ */
+    ActiveLifeEngine();
+
+    std::string name() const;
+    void load(const Grid<int>& board);
+    bool step();
+    int numRows() const { return rows; }
+    int numCols() const { return cols; }
+    int ageAt(int row, int col) const;
+    long long population() const { return outline.population(); }
+
+/**
+ * Births and deaths are counted from the change list as it is built.  The
+ * first call after a load counts the ages, and from then on the change
+ * list updates them as it is applied, so quiet tiles cost nothing here
+ * either.
+ */
+    void stats(LifeStats& stats) const;
+
+/**
+ * Quiet tiles are never visited, so the shape is kept from the births and
+ * deaths in the change list rather than from a pass over the board.
+ */
+    void shape(LifeShape& shape) const { outline.fill(shape); }
+    bool setRule(const LifeRule& newRule);
+
+/**
+ * Returns the number of tiles that the next call to step will visit.
+ */
+    int activeTileCount() const { return static_cast<int>(active.size()); }
+
+private:
+    struct Change {
+        std::size_t index;    // position in ages
+        std::uint8_t age;     // the cell's age in the next generation
+    };
+
+    int rows;
+    int cols;
+    int rowStride;                    // cols plus a zero column on either side
+    int tileRows;
+    int tileCols;
+    std::vector<std::uint8_t> ages;   // (rows + 2) x rowStride, zero border all around
+    std::vector<int> active;          // tiles to visit next step
+    std::vector<bool> scheduled;      // whether a tile is already in active
+    std::vector<Change> changes;      // cells that change this step
+    ShapeTracker outline;             // updated by each step
+    mutable LifeStats counts;         // births, deaths and, once countingAges is set, ages
+    mutable bool countingAges;        // set by the first call to stats after a load
+    LifeRule rule;
+
+    static const int kTileSize = 32;
+
+    std::size_t indexOf(int row, int col) const;
+    void schedule(int tileRow, int tileCol);
+};
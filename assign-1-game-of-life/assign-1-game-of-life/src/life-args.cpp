@@ -0,0 +1,31 @@
+/**
+ * File: life-args.cpp
+ * -------------------
+ * Implements the command-line access shared by the Life driver's modes.
+ */
+
+using namespace std;
+#include "qtgui.h"    // for QtGui
+#include "strlib.h"   // for stringIsInteger, stringToInteger, stringSplit, toLowerCase
+
+#include "life-args.h"
+
+Vector<string> commandLineArgs() {
+    Vector<string> args;
+    int argc = QtGui::instance()->getArgc();
+    char** argv = QtGui::instance()->getArgv();
+    for (int i = 1; i < argc; i++) {
+        args.add(argv[i]);
+    }
+    return args;
+}
+
+bool parseBoardSize(const string& text, int& rows, int& cols) {
+    Vector<string> size = stringSplit(toLowerCase(text), "x");
+    if (size.size() > 2 || !stringIsInteger(size[0]) || !stringIsInteger(size[size.size() - 1])) {
+        return false;
+    }
+    rows = stringToInteger(size[0]);
+    cols = stringToInteger(size[size.size() - 1]);
+    return rows > 0 && cols > 0;
+}
@@ -0,0 +1,24 @@
+/**
+ * File: life-args.h
+ * -----------------
+ * Defines the command-line access shared by the Life driver's batch
+ * modes, so that the benchmark, soup search and regression runner all
+ * read the program's arguments the same way.
+ */
+
+#pragma once
+#include <string>    // for std::string
+#include "vector.h"  // for Vector
+
+/**
+ * Returns the arguments the program was started with, not counting the
+ * program name.
+ */
+Vector<std::string> commandLineArgs();
+
+/**
+ * Reads a board size written ROWSxCOLS, e.g. 512x768, or a single number
+ * for a square board, into rows and cols.  Returns false unless both are
+ * positive integers.
+ */
+bool parseBoardSize(const std::string& text, int& rows, int& cols);
@@ -0,0 +1,275 @@
+/**
+ * File: life-bench.cpp
+ * --------------------
+ * Implements the non-interactive benchmark mode of the Game of Life.
+ */
+
+#include <chrono>     // for steady_clock
+#include <iomanip>    // for setprecision
+#include <iostream>   // for cout
+#include <sstream>    // for ostringstream
+#if !defined(_WIN32)
+#include <sys/resource.h>  // for getrusage
+#endif
+using namespace std;
+#include "console.h"  // for setConsoleEcho
+#include "grid.h"     // for Grid
+#include "random.h"   // for setRandomSeed
+#include "strlib.h"   // for stringIsInteger, stringToInteger, stringIsLong, stringToLong
+
+#include "life-bench.h"
+#include "life-args.h"       // for parseBoardSize
+#include "life-checkpoint.h"  // for saveCheckpoint, loadCheckpoint
+#include "life-cycles.h"     // for CycleDetector
+#include "life-engine.h"     // for createLifeEngine, lifeEngineNames
+#include "life-hashlife.h"   // for HashLifeEngine
+#include "life-parallel.h"   // for ParallelLifeEngine
+#include "life-patterns.h"   // for fillRandomGrid, readPatternFile
+
+static void printUsage();
+static double peakResidentMegabytes();
+
+int runBenchmark(const Vector<string>& args) {
+    setConsoleEcho(true);
+
+    string engineName = "grid";
+    string fileName;
+    string resumeName;
+    string saveName;
+    long long checkpointEvery = 0;
+    int rows = 1024;
+    int cols = 1024;
+    int seed = 1;
+    long long generations = 100;
+    int threads = 0;
+    int exponent = 0;
+    bool stopOnCycle = false;
+    bool wrap = false;
+    LifeRule rule = kConwayRule;
+    bool ruleGiven = false;
+    for (int i = 0; i < args.size(); i++) {
+        bool hasValue = i + 1 < args.size();
+        if (args[i] == "--bench") {
+            continue;
+        } else if (args[i] == "--engine" && hasValue) {
+            engineName = args[++i];
+        } else if (args[i] == "--file" && hasValue) {
+            fileName = args[++i];
+        } else if (args[i] == "--resume" && hasValue) {
+            resumeName = args[++i];
+        } else if (args[i] == "--save" && hasValue) {
+            saveName = args[++i];
+        } else if (args[i] == "--checkpoint-every" && hasValue && stringIsLong(args[i + 1])) {
+            checkpointEvery = stringToLong(args[++i]);
+        } else if (args[i] == "--size" && hasValue && parseBoardSize(args[i + 1], rows, cols)) {
+            i++;
+        } else if (args[i] == "--seed" && hasValue && stringIsInteger(args[i + 1])) {
+            seed = stringToInteger(args[++i]);
+        } else if (args[i] == "--generations" && hasValue && stringIsLong(args[i + 1])) {
+            generations = stringToLong(args[++i]);
+        } else if (args[i] == "--threads" && hasValue && stringIsInteger(args[i + 1])) {
+            threads = stringToInteger(args[++i]);
+        } else if (args[i] == "--exponent" && hasValue && stringIsInteger(args[i + 1])) {
+            exponent = stringToInteger(args[++i]);
+        } else if (args[i] == "--rule" && hasValue) {
+            if (!parseLifeRule(args[++i], rule)) {
+                cout << "Error. " << args[i] << " isn't a B/S rule." << endl;
+                return 1;
+            }
+            ruleGiven = true;
+        } else if (args[i] == "--wrap") {
+            wrap = true;
+        } else if (args[i] == "--stop-on-cycle") {
+            stopOnCycle = true;
+        } else {
+            printUsage();
+            return 1;
+        }
+    }
+    if (checkpointEvery < 0 || generations < 0 || exponent < 0 || exponent > HashLifeEngine::kMaxStepExponent) {
+        printUsage();
+        return 1;
+    }
+    if (!lifeEngineNames().contains(engineName)) {
+        cout << "Error. There is no engine called " << engineName << "." << endl;
+        return 1;
+    }
+
+    Grid<int> board;
+    LifePattern pattern;
+    setRandomSeed(seed);
+    chrono::steady_clock::time_point readStart = chrono::steady_clock::now();
+    if (!resumeName.empty()) {
+        // the board, rule and wrapping come from the checkpoint
+    } else if (fileName.empty()) {
+        fillRandomGrid(board, rows, cols);
+    } else if (!readPatternFile(fileName, pattern)) {
+        cout << "Error. Couldn't read pattern file " << fileName << "." << endl;
+        return 1;
+    } else {
+        rows = pattern.rows;
+        cols = pattern.cols;
+        if (pattern.hasRule && !ruleGiven) {
+            rule = pattern.rule;
+        }
+    }
+    chrono::steady_clock::time_point readEnd = chrono::steady_clock::now();
+
+    LifeEngine* engine = createLifeEngine(engineName);
+    HashLifeEngine* hashLife = dynamic_cast<HashLifeEngine*>(engine);
+    if (hashLife != nullptr) {
+        hashLife->setStepExponent(exponent);
+    }
+    if (generations % engine->stepSize() != 0) {
+        cout << "Error. The " << engine->name() << " engine steps " << engine->stepSize()
+             << " generations at a time, so --generations must be a multiple of that." << endl;
+        delete engine;
+        return 1;
+    }
+    ParallelLifeEngine* parallel = dynamic_cast<ParallelLifeEngine*>(engine);
+    if (parallel != nullptr && threads > 0) {
+        parallel->setThreadCount(threads);
+    }
+    if (!engine->setRule(rule)) {
+        cout << "Error. The " << engine->name() << " engine can't simulate " << lifeRuleString(rule) << "." << endl;
+        delete engine;
+        return 1;
+    }
+    if (wrap && !engine->setWrapping(true)) {
+        cout << "Error. The " << engine->name() << " engine can't wrap around." << endl;
+        delete engine;
+        return 1;
+    }
+
+    LifeCheckpoint state = { 0, static_cast<uint64_t>(seed), rule, wrap };
+    chrono::steady_clock::time_point loadStart = chrono::steady_clock::now();
+    if (!resumeName.empty()) {
+        if (!loadCheckpoint(resumeName, *engine, state)) {
+            cout << "Error. Couldn't resume from checkpoint " << resumeName << "." << endl;
+            delete engine;
+            return 1;
+        }
+        rows = engine->numRows();
+        cols = engine->numCols();
+        seed = static_cast<int>(state.startSeed);
+        rule = state.rule;
+        wrap = state.wrapping;
+    } else if (fileName.empty()) {
+        engine->load(board);
+    } else {
+        engine->loadCells(pattern.rows, pattern.cols, pattern.cells);
+    }
+    chrono::steady_clock::time_point runStart = chrono::steady_clock::now();
+    long long steps = generations / engine->stepSize();
+    long long startGeneration = state.generation;
+    long long nextCheckpoint = startGeneration + checkpointEvery;
+    CycleDetector cycles;
+    bool repeating = stopOnCycle && cycles.observe(*engine, startGeneration);
+    long long taken = 0;
+    while (taken < steps && !repeating) {
+        engine->step();
+        taken++;
+        state.generation = startGeneration + taken * engine->stepSize();
+        repeating = stopOnCycle && cycles.observe(*engine, state.generation);
+        if (checkpointEvery > 0 && !saveName.empty() && state.generation >= nextCheckpoint) {
+            if (!saveCheckpoint(saveName, *engine, state)) {
+                cout << "Error. Couldn't save checkpoint " << saveName << "." << endl;
+            }
+            nextCheckpoint = state.generation + checkpointEvery;
+        }
+    }
+    chrono::steady_clock::time_point runEnd = chrono::steady_clock::now();
+
+    double readSeconds = chrono::duration<double>(readEnd - readStart).count();
+    double loadSeconds = chrono::duration<double>(runStart - loadStart).count();
+    double runSeconds = chrono::duration<double>(runEnd - runStart).count();
+    double simulated = static_cast<double>(taken) * engine->stepSize();
+    double cells = static_cast<double>(rows) * cols;
+    // format into a local stream so that the console's formatting is left alone
+    ostringstream report;
+    report << fixed << setprecision(3);
+    report << "engine:          " << engine->name() << endl;
+    report << "rule:            " << lifeRuleString(rule) << endl;
+    report << "board:           " << rows << "x" << cols
+           << (!resumeName.empty() ? " resumed from " + resumeName
+               : fileName.empty() ? " random" : " from " + fileName) << ", seed " << seed
+           << (wrap ? ", wrapped" : "") << endl;
+    report << "generations:     " << static_cast<long long>(simulated);
+    if (startGeneration > 0) {
+        report << " (" << startGeneration << " to " << state.generation << ")";
+    }
+    report << endl;
+    if (!fileName.empty()) {
+        report << "read time:       " << readSeconds << " s" << endl;
+    }
+    report << "load time:       " << loadSeconds << " s" << endl;
+    report << "run time:        " << runSeconds << " s" << endl;
+    if (simulated > 0 && cells > 0) {
+        report << "generations/sec: " << simulated / runSeconds << endl;
+        report << "ns/cell:         " << runSeconds * 1e9 / (simulated * cells) << endl;
+    }
+    report << "population:      " << engine->population() << endl;
+    if (stopOnCycle) {
+        if (repeating) {
+            report << "cycle:           period " << cycles.period() << " from generation " << cycles.cycleStart();
+            if (cycles.isMoving()) {
+                report << ", moving (" << cycles.rowShift() << ", " << cycles.colShift() << ")";
+            }
+            report << endl;
+        } else {
+            report << "cycle:           none found" << endl;
+        }
+    }
+    if (!saveName.empty()) {
+        chrono::steady_clock::time_point saveStart = chrono::steady_clock::now();
+        if (!saveCheckpoint(saveName, *engine, state)) {
+            report << "Error. Couldn't save checkpoint " << saveName << "." << endl;
+        } else {
+            double saveSeconds = chrono::duration<double>(chrono::steady_clock::now() - saveStart).count();
+            report << "checkpoint:      " << saveName << " in " << saveSeconds << " s" << endl;
+        }
+    }
+    double peak = peakResidentMegabytes();
+    if (peak >= 0) {
+        report << "peak RSS:        " << peak << " MB" << endl;
+    } else {
+        report << "peak RSS:        unavailable" << endl;
+    }
+    cout << report.str();
+
+    delete engine;
+    return 0;
+}
+
+static void printUsage() {
+    cout << "Usage: life --bench [--engine NAME] [--size ROWSxCOLS | --file PATH]" << endl;
+    cout << "            [--seed N] [--generations N] [--threads N] [--exponent K]" << endl;
+    cout << "            [--rule B3/S23] [--wrap] [--stop-on-cycle]" << endl;
+    cout << "            [--resume PATH] [--save PATH] [--checkpoint-every N]" << endl;
+    cout << "Engines:";
+    Vector<string> names = lifeEngineNames();
+    for (int i = 0; i < names.size(); i++) {
+        cout << " " << names[i];
+    }
+    cout << endl;
+}
+
+/**
+ * Returns the largest resident set size of this process so far, in
+ * megabytes, or -1 where the platform does not report it.
+ */
+static double peakResidentMegabytes() {
+#if defined(_WIN32)
+    return -1;
+#else
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0) {
+        return -1;
+    }
+#if defined(__APPLE__)
+    return usage.ru_maxrss / (1024.0 * 1024.0);   // bytes on Mac OS X
+#else
+    return usage.ru_maxrss / 1024.0;              // kilobytes on Linux
+#endif
+#endif
+}
@@ -0,0 +1,38 @@
+/**
+ * File: life-bench.h
+ * ------------------
+ * Defines the non-interactive benchmark mode of the Game of Life.  It
+ * builds a board from command-line arguments, runs an engine for a fixed
+ * number of generations without opening a LifeDisplay, and reports the
+ * throughput so that engine changes can be measured reproducibly.
+ */
+
+#pragma once
+#include <string>    // for std::string
+#include "vector.h"  // for Vector
+
+/**
+ * Runs the benchmark described by args and returns the exit status.
+ * Recognized arguments:
+ *
+ *   --bench                  select this mode
+ *   --engine NAME            engine to run (default grid)
+ *   --size ROWSxCOLS         random board size (default 1024x1024)
+ *   --file PATH              load a pattern file instead of a random board
+ *   --seed N                 random seed for the board and ages (default 1)
+ *   --generations N          generations to simulate (default 100), a multiple
+ *                            of 2^K for hashlife
+ *   --threads N              threads for the parallel engine (default all cores)
+ *   --exponent K             hashlife steps 2^K generations at a time (default 0)
+ *   --rule RULE              birth/survival rule, e.g. B36/S23 (default B3/S23)
+ *   --wrap                   wrap the board around at its edges like a torus
+ *   --stop-on-cycle          stop once the colony repeats, possibly shifted
+ *   --resume PATH            continue from a checkpoint, with its rule and wrapping
+ *   --save PATH              write a checkpoint when the run ends
+ *   --checkpoint-every N     also write it every N generations during the run
+ *
+ * Generations/sec, ns/cell and peak RSS are printed to the console, which
+ * is echoed to standard output.  To run without a display (e.g. in CI),
+ * set QT_QPA_PLATFORM=offscreen.
+ */
+int runBenchmark(const Vector<std::string>& args);
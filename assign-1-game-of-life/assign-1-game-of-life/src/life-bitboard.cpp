@@ -0,0 +1,193 @@
+/**
+ * File: life-bitboard.cpp
+ * -----------------------
+ * Implements the bit-packed Life engine.  Bit j of word w in a row holds
+ * the cell in column 64 * w + j.  Every row carries a zero word on either
+ * side and the plane carries a zero row above and below, so the inner loop
+ * never has to check bounds.
+ */
+
+#include <algorithm>  // for min
+#include <cstring>    // for memcpy, memset
+using namespace std;
+
+#include "life-constants.h"  // for kMaxAge
+#include "life-bitboard.h"
+#include "life-bitwise.h"    // for stepWord, updateAgeBytes, bitCount
+
+BitLifeEngine::BitLifeEngine()
+        : rows(0), cols(0), wordsPerRow(0), stride(2), lastWordMask(0), wrapping(false), countingAges(false) {
+    clearStats(counts);
+    setRule(kConwayRule);
+}
+
+string BitLifeEngine::name() const {
+    return "bitboard";
+}
+
+void BitLifeEngine::load(const Grid<int>& board) {
+    rows = board.numRows();
+    cols = board.numCols();
+    wordsPerRow = (cols + 63) / 64;
+    stride = wordsPerRow + 2;
+    lastWordMask = (cols % 64 == 0) ? ~0ULL : (1ULL << (cols % 64)) - 1;
+    bits.assign(static_cast<size_t>(rows + 2) * stride, 0);
+    next.assign(bits.size(), 0);
+    ages.assign(static_cast<size_t>(rows) * wordsPerRow * 64, 0);
+    clearStats(counts);
+    countingAges = false;
+    outline.reset(rows, cols);
+
+    for (int r = 0; r < rows; r++) {
+        uint64_t* row = bitRow(bits, r);
+        for (int c = 0; c < cols; c++) {
+            int age = min(board.get(r, c), kMaxAge);
+            if (age > 0) {
+                row[1 + c / 64] |= 1ULL << (c % 64);
+                ages[static_cast<size_t>(r) * wordsPerRow * 64 + c] = static_cast<uint8_t>(age);
+                counts.population++;
+                outline.add(r, c);
+            }
+        }
+    }
+}
+
+bool BitLifeEngine::step() {
+    if (wrapping) {
+        fillBorder(bits, true);
+    }
+    bool changed = (this->*stepper)();
+    bits.swap(next);
+    return changed;
+}
+
+int BitLifeEngine::ageAt(int row, int col) const {
+    return ages[static_cast<size_t>(row) * wordsPerRow * 64 + col];
+}
+
+void BitLifeEngine::stats(LifeStats& stats) const {
+    if (!countingAges) {
+        for (int age = 0; age <= kMaxAge; age++) {
+            counts.ages[age] = 0;
+        }
+        for (size_t i = 0; i < ages.size(); i++) {
+            counts.ages[ages[i]]++;
+        }
+        counts.ages[0] = static_cast<long long>(rows) * cols - counts.population;
+        countingAges = true;
+    }
+    stats = counts;
+}
+
+bool BitLifeEngine::setWrapping(bool wrap) {
+    wrapping = wrap;
+    if (!wrap) {
+        fillBorder(bits, false);
+        fillBorder(next, false);
+    }
+    return true;
+}
+
+bool BitLifeEngine::setRule(const LifeRule& newRule) {
+    rule = newRule;
+#define LIFE_SELECT_RULE(B, S) \
+    if (rule.birth == (B) && rule.survival == (S)) { \
+        stepper = &BitLifeEngine::stepRows<(B), (S)>; \
+        return true; \
+    }
+    LIFE_SPECIALIZED_RULES(LIFE_SELECT_RULE)
+#undef LIFE_SELECT_RULE
+    stepper = &BitLifeEngine::stepRows<kAnyRule, kAnyRule>;
+    return true;
+}
+
+uint64_t* BitLifeEngine::bitRow(vector<uint64_t>& plane, int row) {
+    return &plane[static_cast<size_t>(row + 1) * stride];
+}
+
+/**
+ * Refreshes the border around the plane.  The kernel only looks at bit 63
+ * of the word before a row and bit 0 of the word after its last column,
+ * so wrapping stores the last column in the former and the first column
+ * in the latter.  When the last word is not full, the first column goes
+ * into the unused bit just past the last column instead; the kernel masks
+ * that bit out of its result.  The rows above and below are then copied
+ * whole, which fills in the corners as well.  Without wrapping the border
+ * is cleared.
+ */
+void BitLifeEngine::fillBorder(vector<uint64_t>& plane, bool wrap) {
+    if (rows == 0 || cols == 0) {
+        return;
+    }
+    int lastBit = (cols - 1) % 64;
+    for (int r = 0; r < rows; r++) {
+        uint64_t* row = bitRow(plane, r);
+        row[wordsPerRow] &= lastWordMask;
+        row[wordsPerRow + 1] = 0;
+        row[0] = 0;
+        if (wrap) {
+            row[0] = row[wordsPerRow] << (63 - lastBit);
+            if (lastBit == 63) {
+                row[wordsPerRow + 1] = row[1] & 1;
+            } else {
+                row[wordsPerRow] |= (row[1] & 1) << (lastBit + 1);
+            }
+        }
+    }
+    uint64_t* top = bitRow(plane, -1);
+    uint64_t* bottom = bitRow(plane, rows);
+    if (wrap) {
+        memcpy(top, bitRow(plane, rows - 1), stride * sizeof(uint64_t));
+        memcpy(bottom, bitRow(plane, 0), stride * sizeof(uint64_t));
+    } else {
+        memset(top, 0, stride * sizeof(uint64_t));
+        memset(bottom, 0, stride * sizeof(uint64_t));
+    }
+}
+
+/**
+ * Writes the next generation of every row into the scratch plane,
+ * updates the ages, counts the births and deaths and passes them on to
+ * the outline.  Returns true if any age changed.
+ */
+template <unsigned int Birth, unsigned int Survival>
+bool BitLifeEngine::stepRows() {
+    bool changed = false;
+    long long born = 0;
+    long long died = 0;
+    for (int r = 0; r < rows; r++) {
+        const uint64_t* up = bitRow(bits, r - 1);
+        const uint64_t* mid = bitRow(bits, r);
+        const uint64_t* down = bitRow(bits, r + 1);
+        uint64_t* out = bitRow(next, r);
+        for (int w = 1; w <= wordsPerRow; w++) {
+            uint64_t keep;
+            uint64_t grow;
+            stepWordRule<Birth, Survival>(up[w - 1], up[w], up[w + 1], mid[w - 1], mid[w], mid[w + 1],
+                                          down[w - 1], down[w], down[w + 1], rule, keep, grow);
+            uint64_t before = mid[w];
+            if (w == wordsPerRow) {
+                grow &= lastWordMask;
+                keep &= lastWordMask;
+                before &= lastWordMask;   // drops the wrapped column stored past the end
+            }
+
+            uint8_t* cells = &ages[(static_cast<size_t>(r) * wordsPerRow + w - 1) * 64];
+            out[w] = grow | (keep & mid[w]);
+            if ((before | grow) != 0) {
+                uint64_t bornBits = out[w] & ~before;
+                uint64_t diedBits = before & ~out[w];
+                born += bitCount(bornBits);
+                died += bitCount(diedBits);
+                outline.update(r, 64 * (w - 1), bornBits, diedBits);
+                if (countingAges ? updateAgeBytes(cells, keep, grow, counts.ages) : updateAgeBytes(cells, keep, grow)) {
+                    changed = true;
+                }
+            }
+        }
+    }
+    counts.births = born;
+    counts.deaths = died;
+    counts.population += born - died;
+    return changed;
+}
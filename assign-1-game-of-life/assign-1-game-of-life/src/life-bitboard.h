@@ -0,0 +1,69 @@
+/**
+ * File: life-bitboard.h
+ * ---------------------
+ * Defines a Life engine that packs the colony into rows of 64-bit words,
+ * one bit per cell, and computes 64 cells of the next generation at once
+ * using bitwise adders.  Ages live in a separate byte plane so that the
+ * display can still shade cells by age.
+ */
+
+#pragma once
+#include <cstdint>   // for uint8_t, uint64_t
+#include <string>    // for std::string
+#include <vector>    // for std::vector
+#include "grid.h"    // for Grid
+
+#include "life-engine.h"
+#include "life-shape.h"   // for ShapeTracker
+
+class BitLifeEngine : public LifeEngine {
+public:
+/**
+ * Constructs an empty engine.  Call load before stepping.
+ */
+    BitLifeEngine();
+
+    std::string name() const;
+    void load(const Grid<int>& board);
+    bool step();
+    int numRows() const { return rows; }
+    int numCols() const { return cols; }
+    int ageAt(int row, int col) const;
+    long long population() const { return counts.population; }
+
+/**
+ * Population, births and deaths are counted a word at a time while
+ * stepping.  The first call after a load counts the ages, and from then
+ * on each step moves the cells whose age changes between the counts, so
+ * runs that never ask for stats do not pay for keeping them.
+ */
+    void stats(LifeStats& stats) const;
+
+/**
+ * The shape is updated a word at a time from the births and deaths that
+ * stepping already computes.
+ */
+    void shape(LifeShape& shape) const { outline.fill(shape); }
+    bool setWrapping(bool wrap);
+    bool setRule(const LifeRule& newRule);
+
+private:
+    int rows;
+    int cols;
+    int wordsPerRow;                  // words holding real cells in each row
+    int stride;                       // wordsPerRow plus a zero word on either side
+    std::uint64_t lastWordMask;       // clears the columns past cols in the last word
+    std::vector<std::uint64_t> bits;  // (rows + 2) x stride, zero border all around
+    std::vector<std::uint64_t> next;  // scratch plane swapped with bits each step
+    std::vector<std::uint8_t> ages;   // rows x (64 * wordsPerRow), one byte per cell
+    bool wrapping;
+    LifeRule rule;
+    mutable LifeStats counts;         // updated by each step, the ages only once countingAges is set
+    mutable bool countingAges;        // set by the first call to stats after a load
+    ShapeTracker outline;             // updated by each step
+    bool (BitLifeEngine::*stepper)();  // stepRows specialized for the rule
+
+    std::uint64_t* bitRow(std::vector<std::uint64_t>& plane, int row);
+    void fillBorder(std::vector<std::uint64_t>& plane, bool wrap);
+    template <unsigned int Birth, unsigned int Survival> bool stepRows();
+};
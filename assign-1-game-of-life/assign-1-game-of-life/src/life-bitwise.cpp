@@ -0,0 +1,93 @@
+/**
+ * File: life-bitwise.cpp
+ * ----------------------
+ * Implements the age update shared by the bit-packed engines.
+ */
+
+#include <cstring>    // for memcpy
+using namespace std;
+
+#include "life-constants.h"  // for kMaxAge
+#include "life-bitwise.h"
+
+static const uint64_t kByteOnes = 0x0101010101010101ULL;
+static const uint64_t kByteLows = 0x7f7f7f7f7f7f7f7fULL;
+
+/**
+ * Struct: SpreadTable
+ * -------------------
+ * Maps each byte to an 8-byte word whose byte i (in memory order) is 1
+ * exactly when bit i of the byte is set.
+ */
+struct SpreadTable {
+    uint64_t words[256];
+
+    SpreadTable() {
+        for (int b = 0; b < 256; b++) {
+            uint8_t lanes[8];
+            for (int i = 0; i < 8; i++) {
+                lanes[i] = (b >> i) & 1;
+            }
+            memcpy(&words[b], lanes, sizeof(lanes));
+        }
+    }
+};
+
+/**
+ * Function: spreadBits
+ * --------------------
+ * Returns the spread form of the given byte.  The table is built on first
+ * use, which is safe even when several engines start stepping at once.
+ */
+static uint64_t spreadBits(unsigned int byte) {
+    static const SpreadTable table;
+    return table.words[byte];
+}
+
+/**
+ * Function: stepAgeBytes
+ * ----------------------
+ * Does the work of both updateAgeBytes overloads.  CountAges selects at
+ * compile time whether changes are counted, so the version that does not
+ * count pays nothing for it.
+ */
+template <bool CountAges>
+static inline bool stepAgeBytes(uint8_t* cells, uint64_t keep, uint64_t grow, long long* ageCounts) {
+    const uint64_t maxPlusOne = kByteOnes * (kMaxAge + 1);
+    bool changed = false;
+    for (int group = 0; group < 8; group++, cells += 8) {
+        uint64_t before;
+        memcpy(&before, cells, 8);
+        uint64_t after = (before & (spreadBits((keep >> (8 * group)) & 0xff) * 0xff))
+                + spreadBits((grow >> (8 * group)) & 0xff);
+
+        // step any lane that reached kMaxAge + 1 back down to kMaxAge
+        uint64_t diff = after ^ maxPlusOne;
+        uint64_t saturated = ~(((diff & kByteLows) + kByteLows) | diff | kByteLows);
+        after -= saturated >> 7;
+
+        if (after != before) {
+            memcpy(cells, &after, 8);
+            changed = true;
+            if (CountAges) {
+                // set the top bit of each lane that changed and move those lanes' counts
+                uint64_t moved = after ^ before;
+                moved = (((moved & kByteLows) + kByteLows) | moved) & ~kByteLows;
+                for (; moved != 0; moved &= moved - 1) {
+                    int shift = lowestBit(moved) - 7;
+                    ageCounts[(before >> shift) & 0xff]--;
+                    ageCounts[(after >> shift) & 0xff]++;
+                }
+            }
+        }
+    }
+    return changed;
+}
+
+bool updateAgeBytes(uint8_t* cells, uint64_t keep, uint64_t grow) {
+    return stepAgeBytes<false>(cells, keep, grow, nullptr);
+}
+
+bool updateAgeBytes(uint8_t* cells, uint64_t keep, uint64_t grow, long long* ageCounts) {
+    return stepAgeBytes<true>(cells, keep, grow, ageCounts);
+}
@@ -0,0 +1,180 @@
+/**
+ * File: life-bitwise.h
+ * --------------------
+ * Defines the word-at-a-time building blocks shared by the engines that
+ * pack 64 cells into each 64-bit word, where bit j of a word holds the
+ * j-th cell of its run of 64 columns.
+ */
+
+#pragma once
+#include <cstdint>   // for uint64_t, uint8_t
+
+#include "life-rules.h"      // for LifeRule, kAnyRule, kConwayBirth, kConwaySurvival
+
+/**
+ * Computes the next generation of the 64 cells in mid.  Each row is given
+ * as the word itself along with the words to its left and right, so that
+ * the neighbors of bits 0 and 63 can be shifted in.  On return, keep holds
+ * the cells with 2 or 3 neighbors and grow the cells with exactly 3, so
+ * the next word is grow | (keep & mid).
+ */
+inline void stepWord(std::uint64_t upLeft, std::uint64_t up, std::uint64_t upRight,
+                     std::uint64_t left, std::uint64_t mid, std::uint64_t right,
+                     std::uint64_t downLeft, std::uint64_t down, std::uint64_t downRight,
+                     std::uint64_t& keep, std::uint64_t& grow) {
+    // the eight neighbor planes, lined up with the cells of this word
+    std::uint64_t nw = (up << 1) | (upLeft >> 63);
+    std::uint64_t ne = (up >> 1) | (upRight << 63);
+    std::uint64_t west = (mid << 1) | (left >> 63);
+    std::uint64_t east = (mid >> 1) | (right << 63);
+    std::uint64_t sw = (down << 1) | (downLeft >> 63);
+    std::uint64_t se = (down >> 1) | (downRight << 63);
+
+    // add each row's neighbors into a two-bit sum
+    std::uint64_t upLo = nw ^ up ^ ne;
+    std::uint64_t upHi = (nw & up) | (ne & (nw ^ up));
+    std::uint64_t midLo = west ^ east;
+    std::uint64_t midHi = west & east;
+    std::uint64_t downLo = sw ^ down ^ se;
+    std::uint64_t downHi = (sw & down) | (se & (sw ^ down));
+
+    // count = ones + 2 * (number of set twos), so the count is 2 or 3
+    // exactly when exactly one of the four twos is set
+    std::uint64_t ones = upLo ^ midLo ^ downLo;
+    std::uint64_t carry = (upLo & midLo) | (downLo & (upLo ^ midLo));
+    std::uint64_t oneTwo = (upHi ^ midHi ^ downHi ^ carry) & ~(upHi & midHi) & ~(downHi & carry);
+    grow = oneTwo & ones;
+    keep = oneTwo;
+}
+
+/**
+ * Returns the lanes whose neighbor count, held in the bit planes s0 (ones)
+ * through s3 (eights), is one of the counts in mask.  When mask is a
+ * constant the tests for the other counts compile away.
+ */
+inline std::uint64_t countIn(unsigned int mask, std::uint64_t s0, std::uint64_t s1,
+                             std::uint64_t s2, std::uint64_t s3) {
+    std::uint64_t low = ~s3 & ~s2;
+    std::uint64_t high = ~s3 & s2;
+    std::uint64_t matches = 0;
+    if (mask & (1 << 0)) matches |= low & ~s1 & ~s0;
+    if (mask & (1 << 1)) matches |= low & ~s1 & s0;
+    if (mask & (1 << 2)) matches |= low & s1 & ~s0;
+    if (mask & (1 << 3)) matches |= low & s1 & s0;
+    if (mask & (1 << 4)) matches |= high & ~s1 & ~s0;
+    if (mask & (1 << 5)) matches |= high & ~s1 & s0;
+    if (mask & (1 << 6)) matches |= high & s1 & ~s0;
+    if (mask & (1 << 7)) matches |= high & s1 & s0;
+    if (mask & (1 << 8)) matches |= s3;
+    return matches;
+}
+
+/**
+ * Works like stepWord under any birth/survival rule.  Birth and Survival
+ * give the rule at compile time, or are kAnyRule to take it from rule.
+ * Here grow holds the cells that are born or survive with a count that
+ * would also give birth, which is what updateAgeBytes expects.
+ */
+template <unsigned int Birth, unsigned int Survival>
+inline void stepWordRule(std::uint64_t upLeft, std::uint64_t up, std::uint64_t upRight,
+                         std::uint64_t left, std::uint64_t mid, std::uint64_t right,
+                         std::uint64_t downLeft, std::uint64_t down, std::uint64_t downRight,
+                         const LifeRule& rule, std::uint64_t& keep, std::uint64_t& grow) {
+    const unsigned int birth = (Birth == kAnyRule) ? rule.birth : Birth;
+    const unsigned int survival = (Survival == kAnyRule) ? rule.survival : Survival;
+
+    std::uint64_t nw = (up << 1) | (upLeft >> 63);
+    std::uint64_t ne = (up >> 1) | (upRight << 63);
+    std::uint64_t west = (mid << 1) | (left >> 63);
+    std::uint64_t east = (mid >> 1) | (right << 63);
+    std::uint64_t sw = (down << 1) | (downLeft >> 63);
+    std::uint64_t se = (down >> 1) | (downRight << 63);
+
+    // add each row's neighbors into a two-bit sum, then add the sums
+    std::uint64_t upLo = nw ^ up ^ ne;
+    std::uint64_t upHi = (nw & up) | (ne & (nw ^ up));
+    std::uint64_t midLo = west ^ east;
+    std::uint64_t midHi = west & east;
+    std::uint64_t downLo = sw ^ down ^ se;
+    std::uint64_t downHi = (sw & down) | (se & (sw ^ down));
+    std::uint64_t s0 = upLo ^ midLo ^ downLo;
+    std::uint64_t carry = (upLo & midLo) | (downLo & (upLo ^ midLo));
+
+    // the twos: upHi + midHi + downHi + carry, at most 4 of them
+    std::uint64_t pairLo = upHi ^ midHi;
+    std::uint64_t pairHi = downHi ^ carry;
+    std::uint64_t s1 = pairLo ^ pairHi;
+    std::uint64_t both1 = upHi & midHi;
+    std::uint64_t both2 = downHi & carry;
+    std::uint64_t s2 = both1 ^ both2 ^ (pairLo & pairHi);
+    std::uint64_t s3 = both1 & both2;
+
+    keep = countIn(survival, s0, s1, s2, s3);
+    grow = countIn(birth, s0, s1, s2, s3) & (keep | ~mid);
+}
+
+template <>
+inline void stepWordRule<kConwayBirth, kConwaySurvival>(std::uint64_t upLeft, std::uint64_t up, std::uint64_t upRight,
+                                                       std::uint64_t left, std::uint64_t mid, std::uint64_t right,
+                                                       std::uint64_t downLeft, std::uint64_t down,
+                                                       std::uint64_t downRight, const LifeRule&,
+                                                       std::uint64_t& keep, std::uint64_t& grow) {
+    stepWord(upLeft, up, upRight, left, mid, right, downLeft, down, downRight, keep, grow);
+}
+
+/**
+ * Applies one generation to the 64 age bytes under a word, eight at a
+ * time.  Cells outside keep die, and cells in grow gain a generation
+ * (saturating at kMaxAge).  Returns true if any age changed.  The second
+ * form also moves every cell whose age changes from ageCounts[old age]
+ * to ageCounts[new age].
+ */
+bool updateAgeBytes(std::uint8_t* cells, std::uint64_t keep, std::uint64_t grow);
+bool updateAgeBytes(std::uint8_t* cells, std::uint64_t keep, std::uint64_t grow, long long* ageCounts);
+
+/**
+ * Returns the index of the lowest set bit of a nonzero word.
+ */
+inline int lowestBit(std::uint64_t word) {
+#if defined(__GNUC__)
+    return __builtin_ctzll(word);
+#else
+    int index = 0;
+    while ((word & 1) == 0) {
+        word >>= 1;
+        index++;
+    }
+    return index;
+#endif
+}
+
+/**
+ * Returns the index of the highest set bit of a nonzero word.
+ */
+inline int highestBit(std::uint64_t word) {
+#if defined(__GNUC__)
+    return 63 - __builtin_clzll(word);
+#else
+    int index = 63;
+    while ((word >> 63) == 0) {
+        word <<= 1;
+        index--;
+    }
+    return index;
+#endif
+}
+
+/**
+ * Returns the number of set bits in a word.
+ */
+inline int bitCount(std::uint64_t word) {
+#if defined(__GNUC__)
+    return __builtin_popcountll(word);
+#else
+    int count = 0;
+    for (; word != 0; word &= word - 1) {
+        count++;
+    }
+    return count;
+#endif
+}
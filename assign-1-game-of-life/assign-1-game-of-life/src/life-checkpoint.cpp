@@ -0,0 +1,288 @@
+/**
+ * File: life-checkpoint.cpp
+ * -------------------------
+ * Implements saving and restoring binary checkpoints.  On Windows, where
+ * there is no mmap, the file is read into memory with a single read.
+ */
+
+#include <algorithm>  // for min, max
+#include <climits>    // for INT_MAX
+#include <cstdio>     // for remove, rename
+#include <cstring>    // for memcpy, memcmp, memset
+#include <fstream>    // for file write
+#include <vector>     // for vector
+#if defined(_WIN32)
+#include <iterator>   // for istreambuf_iterator
+#else
+#include <fcntl.h>     // for open
+#include <sys/mman.h>  // for mmap, munmap
+#include <sys/stat.h>  // for fstat
+#include <unistd.h>    // for close
+#endif
+using namespace std;
+#include "grid.h"     // for Grid
+
+#include "life-checkpoint.h"
+#include "life-bitwise.h"    // for lowestBit, bitCount
+
+static const char kMagic[8] = { 'L', 'I', 'F', 'E', 'C', 'K', 'P', 'T' };
+static const uint32_t kVersion = 1;
+static const uint32_t kByteOrder = 0x01020304;
+static const long long kMaxBoardCells = 1LL << 32;   // largest board a checkpoint may ask an engine for
+
+/**
+ * The fixed-size header at the start of every checkpoint.  Every field is
+ * naturally aligned, so the struct has no padding.
+ */
+struct CheckpointHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t byteOrder;           // kByteOrder as written by the saving machine
+    int32_t rows;                 // the board reported by numRows and numCols
+    int32_t cols;
+    int32_t planeTop;             // bounding box of the live cells
+    int32_t planeLeft;
+    int32_t planeRows;
+    int32_t planeCols;
+    uint32_t birth;
+    uint32_t survival;
+    uint32_t wrapping;
+    uint32_t reserved;
+    int64_t generation;
+    uint64_t startSeed;           // seed the run was started from, not the generator's state
+    uint64_t population;
+};
+
+static_assert(sizeof(CheckpointHeader) == 80, "checkpoint header must be 80 bytes");
+
+/**
+ * Class: MappedFile
+ * -----------------
+ * Holds the read-only contents of a file for as long as it is in scope.
+ */
+class MappedFile {
+public:
+    explicit MappedFile(const string& fileName) : bytes(nullptr), length(0) {
+#if defined(_WIN32)
+        ifstream input(fileName.c_str(), ios::in | ios::binary);
+        if (!input.fail()) {
+            contents.assign(istreambuf_iterator<char>(input), istreambuf_iterator<char>());
+            bytes = contents.data();
+            length = contents.size();
+        }
+#else
+        int fd = open(fileName.c_str(), O_RDONLY);
+        if (fd < 0) {
+            return;
+        }
+        struct stat info;
+        if (fstat(fd, &info) == 0 && info.st_size > 0) {
+            void* mapped = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+            if (mapped != MAP_FAILED) {
+                bytes = static_cast<const char*>(mapped);
+                length = static_cast<size_t>(info.st_size);
+            }
+        }
+        close(fd);
+#endif
+    }
+
+    ~MappedFile() {
+#if !defined(_WIN32)
+        if (bytes != nullptr) {
+            munmap(const_cast<char*>(bytes), length);
+        }
+#endif
+    }
+
+    const char* data() const { return bytes; }
+    size_t size() const { return length; }
+
+private:
+    const char* bytes;
+    size_t length;
+#if defined(_WIN32)
+    vector<char> contents;
+#endif
+
+    MappedFile(const MappedFile& original);
+    void operator=(const MappedFile& rhs) const;
+};
+
+bool saveCheckpoint(const string& fileName, const LifeEngine& engine, const LifeCheckpoint& state) {
+    vector<LifeCell> cells;
+    engine.liveCells(cells);
+    int top = 0;
+    int left = 0;
+    int bottom = -1;
+    int right = -1;
+    if (!cells.empty()) {
+        top = bottom = cells[0].row;
+        left = right = cells[0].col;
+    }
+    for (size_t i = 0; i < cells.size(); i++) {
+        top = min(top, cells[i].row);
+        left = min(left, cells[i].col);
+        bottom = max(bottom, cells[i].row);
+        right = max(right, cells[i].col);
+    }
+    if (static_cast<long long>(bottom) - top + 1 > INT_MAX || static_cast<long long>(right) - left + 1 > INT_MAX) {
+        return false;   // cells spread wider than the header can describe
+    }
+    int planeRows = bottom - top + 1;
+    int planeCols = right - left + 1;
+    size_t wordsPerRow = (static_cast<size_t>(planeCols) + 63) / 64;
+    vector<uint64_t> bits(static_cast<size_t>(planeRows) * wordsPerRow, 0);
+    for (size_t i = 0; i < cells.size(); i++) {
+        int c = cells[i].col - left;
+        bits[static_cast<size_t>(cells[i].row - top) * wordsPerRow + c / 64] |= 1ULL << (c % 64);
+    }
+
+    // ages are stored in bit plane order, whatever order the engine gave
+    // the cells in, so each cell's slot is the number of set bits before it
+    vector<uint64_t> firstIndex(bits.size());
+    uint64_t population = 0;
+    for (size_t w = 0; w < bits.size(); w++) {
+        firstIndex[w] = population;
+        population += bitCount(bits[w]);
+    }
+    vector<uint8_t> ages(static_cast<size_t>((population + 1) / 2), 0);
+    for (size_t i = 0; i < cells.size(); i++) {
+        int c = cells[i].col - left;
+        size_t w = static_cast<size_t>(cells[i].row - top) * wordsPerRow + c / 64;
+        uint64_t index = firstIndex[w] + bitCount(bits[w] & ((1ULL << (c % 64)) - 1));
+        ages[index / 2] |= static_cast<uint8_t>(min(cells[i].age, 15) << (4 * (index % 2)));
+    }
+
+    CheckpointHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.version = kVersion;
+    header.byteOrder = kByteOrder;
+    header.rows = engine.numRows();
+    header.cols = engine.numCols();
+    header.planeTop = top;
+    header.planeLeft = left;
+    header.planeRows = planeRows;
+    header.planeCols = planeCols;
+    header.birth = state.rule.birth;
+    header.survival = state.rule.survival;
+    header.wrapping = state.wrapping ? 1 : 0;
+    header.generation = state.generation;
+    header.startSeed = state.startSeed;
+    header.population = population;
+
+    string tempName = fileName + ".tmp";
+    {
+        ofstream output(tempName.c_str(), ios::out | ios::binary | ios::trunc);
+        output.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        output.write(reinterpret_cast<const char*>(bits.data()), bits.size() * sizeof(uint64_t));
+        output.write(reinterpret_cast<const char*>(ages.data()), ages.size());
+        output.close();
+        if (output.fail()) {
+            remove(tempName.c_str());
+            return false;
+        }
+    }
+#if defined(_WIN32)
+    remove(fileName.c_str());   // rename does not replace existing files here
+#endif
+    if (rename(tempName.c_str(), fileName.c_str()) != 0) {
+        remove(tempName.c_str());
+        return false;
+    }
+    return true;
+}
+
+bool loadCheckpoint(const string& fileName, LifeEngine& engine, LifeCheckpoint& state) {
+    MappedFile file(fileName);
+    if (file.data() == nullptr || file.size() < sizeof(CheckpointHeader)) {
+        return false;
+    }
+    CheckpointHeader header;
+    memcpy(&header, file.data(), sizeof(header));
+    if (memcmp(header.magic, kMagic, sizeof(kMagic)) != 0 || header.version != kVersion
+            || header.byteOrder != kByteOrder || header.rows < 0 || header.cols < 0
+            || header.planeRows < 0 || header.planeCols < 0) {
+        return false;
+    }
+    // the header is not trusted: the plane must fit in int coordinates and
+    // hold its population, the file must be exactly as long as the plane
+    // and ages make it, and the board must be one an engine can allocate
+    long long planeBottom = static_cast<long long>(header.planeTop) + header.planeRows;
+    long long planeRight = static_cast<long long>(header.planeLeft) + header.planeCols;
+    long long planeCells = static_cast<long long>(header.planeRows) * header.planeCols;
+    long long boardCells = static_cast<long long>(header.rows) * header.cols;
+    if (planeBottom - 1 > INT_MAX || planeRight - 1 > INT_MAX
+            || header.population > static_cast<uint64_t>(planeCells) || boardCells > kMaxBoardCells) {
+        return false;
+    }
+    uint64_t wordsPerRow = (static_cast<uint64_t>(header.planeCols) + 63) / 64;
+    uint64_t wordCount = static_cast<uint64_t>(header.planeRows) * wordsPerRow;
+    uint64_t ageBytes = (header.population + 1) / 2;
+    if (static_cast<uint64_t>(file.size()) != sizeof(header) + wordCount * sizeof(uint64_t) + ageBytes) {
+        return false;
+    }
+
+    // try the rule and wrapping on a fresh engine of the same kind first,
+    // so that an engine that can't run them is left exactly as it was
+    LifeRule rule = { header.birth, header.survival };
+    LifeEngine* probe = createLifeEngine(engine.name());
+    bool supported = probe->setRule(rule) && probe->setWrapping(header.wrapping != 0);
+    delete probe;
+    if (!supported) {
+        return false;
+    }
+
+    // the header is 80 bytes and the mapping is page aligned, so the
+    // words can be read in place
+    const uint64_t* bits = reinterpret_cast<const uint64_t*>(file.data() + sizeof(header));
+    const uint8_t* ages = reinterpret_cast<const uint8_t*>(file.data() + sizeof(header) + wordCount * sizeof(uint64_t));
+    // a plane inside the board that covers much of it is decoded straight
+    // into a board for load; cells an unbounded engine has carried off it,
+    // or a few cells on a large board, go through loadCells instead
+    bool insideBoard = header.planeTop >= 0 && header.planeLeft >= 0
+            && planeBottom <= header.rows && planeRight <= header.cols
+            && boardCells <= 4 * planeCells;
+    Grid<int> board;
+    vector<LifeCell> cells;
+    if (insideBoard) {
+        board.resize(header.rows, header.cols);
+    }
+    uint64_t index = 0;
+    for (int r = 0; r < header.planeRows; r++) {
+        const uint64_t* row = bits + static_cast<size_t>(r * wordsPerRow);
+        for (uint64_t w = 0; w < wordsPerRow; w++) {
+            for (uint64_t word = row[w]; word != 0; word &= word - 1) {
+                int col = static_cast<int>(w * 64) + lowestBit(word);
+                if (index >= header.population || col >= header.planeCols) {
+                    return false;
+                }
+                int age = (ages[index / 2] >> (4 * (index % 2))) & 0xf;
+                if (insideBoard) {
+                    board[header.planeTop + r][header.planeLeft + col] = age;
+                } else {
+                    LifeCell cell = { header.planeTop + r, header.planeLeft + col, age };
+                    cells.push_back(cell);
+                }
+                index++;
+            }
+        }
+    }
+    if (index != header.population) {
+        return false;
+    }
+
+    engine.setRule(rule);
+    engine.setWrapping(header.wrapping != 0);
+    if (insideBoard) {
+        engine.load(board);
+    } else {
+        engine.loadCells(header.rows, header.cols, cells);
+    }
+    state.generation = header.generation;
+    state.startSeed = header.startSeed;
+    state.rule = rule;
+    state.wrapping = (header.wrapping != 0);
+    return true;
+}
@@ -0,0 +1,52 @@
+/**
+ * File: life-checkpoint.h
+ * -----------------------
+ * Defines a compact binary checkpoint of a running colony, so that a long
+ * run can be saved and resumed later.  A checkpoint holds an 80-byte
+ * header, a bit plane covering the live cells' bounding box with one bit
+ * per cell packed into 64-bit words row by row, and then the age of each
+ * live cell as a 4-bit nibble in the same order.  Cells that an unbounded
+ * engine has carried off the board are saved too.  All fields are in the
+ * byte order of the machine that wrote them.  Restoring maps the file
+ * into memory and decodes it in a single pass.
+ */
+
+#pragma once
+#include <cstdint>   // for uint64_t
+#include <string>    // for std::string
+
+#include "life-engine.h"
+#include "life-rules.h"      // for LifeRule
+
+/**
+ * The run state saved alongside the board.  Engines keep their rule and
+ * wrapping private, so the driver passes them in here when saving.  The
+ * library's random generator does not expose its state, so only the seed
+ * the run started from is kept; a resumed run does not continue the
+ * original random sequence.
+ */
+struct LifeCheckpoint {
+    long long generation;
+    std::uint64_t startSeed;       // seed the run was started from
+    LifeRule rule;
+    bool wrapping;
+};
+
+/**
+ * Writes the engine's board and the given run state to fileName.  The
+ * file is written under a temporary name and then renamed, so an earlier
+ * checkpoint is never left half overwritten.  Returns false if the file
+ * could not be written or the live cells span more than an int's range.
+ */
+bool saveCheckpoint(const std::string& fileName, const LifeEngine& engine, const LifeCheckpoint& state);
+
+/**
+ * Reads a checkpoint written by saveCheckpoint, loads its board into the
+ * engine and stores the run state in state.  The engine is switched to
+ * the saved rule and wrapping.  The header is checked against the file's
+ * length before anything is allocated.  Returns false without touching
+ * the engine if the file cannot be read, is not a valid checkpoint,
+ * describes a board of more than 2^32 cells, or asks for a rule or
+ * wrapping the engine cannot simulate.
+ */
+bool loadCheckpoint(const std::string& fileName, LifeEngine& engine, LifeCheckpoint& state);
@@ -0,0 +1,382 @@
+/**
+ * File: life-chunked.cpp
+ * ----------------------
+ * Implements the chunked Life engine.  Every chunk holds two bit planes,
+ * and all chunks flip between them together, so a step reads one plane
+ * of each neighbor while writing the other.  Ages belong to a single
+ * cell and are never read by neighbors, so they are updated in place.
+ * A chunk that does not exist yet is only visited when a neighbor has
+ * live cells on the shared edge, since births cannot happen anywhere else.
+ */
+
+#include <algorithm>  // for min, max
+#include <climits>    // for INT_MAX, INT_MIN
+#include <cstring>    // for memset
+using namespace std;
+
+#include "life-constants.h"  // for kMaxAge
+#include "life-chunked.h"
+#include "life-bitwise.h"    // for stepWord, updateAgeBytes, lowestBit, highestBit, bitCount
+#include "life-shape.h"      // for cellHash, wordHash, kRowHashBase, kColHashBase
+
+size_t ChunkLifeEngine::KeyHash::operator()(uint64_t key) const {
+    uint64_t x = key * 0x9e3779b97f4a7c15ULL;
+    return static_cast<size_t>(x ^ (x >> 32));
+}
+
+ChunkLifeEngine::ChunkLifeEngine() : rows(0), cols(0), phase(0), countingAges(false) {
+    memset(&emptyChunk, 0, sizeof(emptyChunk));
+    memset(&outline, 0, sizeof(outline));
+    clearStats(counts);
+    uint64_t hash = 1;
+    for (int c = 0; c < kChunkSize; c++) {
+        colHashes[c] = hash;
+        hash *= kColHashBase;
+    }
+    setRule(kConwayRule);
+}
+
+ChunkLifeEngine::~ChunkLifeEngine() {
+    clearChunks();
+    for (size_t i = 0; i < spareChunks.size(); i++) {
+        delete spareChunks[i];
+    }
+}
+
+string ChunkLifeEngine::name() const {
+    return "chunked";
+}
+
+void ChunkLifeEngine::load(const Grid<int>& board) {
+    clearChunks();
+    rows = board.numRows();
+    cols = board.numCols();
+    phase = 0;
+    for (int r = 0; r < rows; r++) {
+        for (int c = 0; c < cols; c++) {
+            setCell(r, c, board.get(r, c));
+        }
+    }
+    traceOutline();
+}
+
+void ChunkLifeEngine::loadCells(int numRows, int numCols, const vector<LifeCell>& cells) {
+    clearChunks();
+    rows = numRows;
+    cols = numCols;
+    phase = 0;
+    for (size_t i = 0; i < cells.size(); i++) {
+        setCell(cells[i].row, cells[i].col, cells[i].age);
+    }
+    traceOutline();
+}
+
+bool ChunkLifeEngine::step() {
+    bool changed = false;
+    counts.births = 0;
+    counts.deaths = 0;
+    outline.top = INT_MAX;
+    outline.left = INT_MAX;
+    outline.bottom = INT_MIN;
+    outline.right = INT_MIN;
+    stepping.clear();
+    for (ChunkMap::iterator it = chunks.begin(); it != chunks.end(); ++it) {
+        stepping.push_back(it->second);
+    }
+
+    for (size_t i = 0; i < stepping.size(); i++) {
+        Chunk* chunk = stepping[i];
+        if ((this->*stepper)(chunk)) {
+            changed = true;
+        }
+
+        // births can spill into a missing neighbor only across an edge with live cells
+        const uint64_t* bits = chunk->planes[phase];
+        uint64_t columns = 0;
+        for (int r = 0; r < kChunkSize; r++) {
+            columns |= bits[r];
+        }
+        bool north = bits[0] != 0;
+        bool south = bits[kChunkSize - 1] != 0;
+        bool west = (columns & 1) != 0;
+        bool east = (columns >> (kChunkSize - 1)) != 0;
+        for (int dr = -1; dr <= 1; dr++) {
+            for (int dc = -1; dc <= 1; dc++) {
+                bool touchesRow = (dr == 0) || (dr < 0 ? north : south);
+                bool touchesCol = (dc == 0) || (dc < 0 ? west : east);
+                if ((dr == 0 && dc == 0) || !touchesRow || !touchesCol) {
+                    continue;
+                }
+                int chunkRow = chunk->chunkRow + dr;
+                int chunkCol = chunk->chunkCol + dc;
+                if (find(chunkRow, chunkCol) != &emptyChunk) {
+                    continue;
+                }
+                Chunk* fresh = allocate(chunkRow, chunkCol);
+                (this->*stepper)(fresh);
+                if (fresh->emptyNext) {
+                    chunks.erase(keyOf(chunkRow, chunkCol));
+                    release(fresh);
+                } else {
+                    changed = true;
+                }
+            }
+        }
+    }
+
+    if (outline.population == 0) {
+        outline.top = 0;
+        outline.left = 0;
+        outline.bottom = 0;
+        outline.right = 0;
+    }
+    phase = 1 - phase;
+    for (ChunkMap::iterator it = chunks.begin(); it != chunks.end(); ) {
+        if (it->second->emptyNext) {
+            release(it->second);
+            it = chunks.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    return changed;
+}
+
+void ChunkLifeEngine::stats(LifeStats& stats) const {
+    if (!countingAges) {
+        for (int age = 0; age <= kMaxAge; age++) {
+            counts.ages[age] = 0;
+        }
+        for (ChunkMap::const_iterator it = chunks.begin(); it != chunks.end(); ++it) {
+            const Chunk* chunk = it->second;
+            for (int r = 0; r < kChunkSize; r++) {
+                for (uint64_t word = chunk->planes[phase][r]; word != 0; word &= word - 1) {
+                    counts.ages[chunk->ages[r * kChunkSize + lowestBit(word)]]++;
+                }
+            }
+        }
+        countingAges = true;
+    }
+    stats = counts;
+    stats.population = outline.population;
+    stats.ages[0] = max(0LL, static_cast<long long>(rows) * cols - outline.population);
+}
+
+int ChunkLifeEngine::ageAt(int row, int col) const {
+    int chunkRow = chunkOf(row);
+    int chunkCol = chunkOf(col);
+    const Chunk* chunk = find(chunkRow, chunkCol);
+    return chunk->ages[(row - chunkRow * kChunkSize) * kChunkSize + (col - chunkCol * kChunkSize)];
+}
+
+void ChunkLifeEngine::liveCells(vector<LifeCell>& cells) const {
+    cells.clear();
+    for (ChunkMap::const_iterator it = chunks.begin(); it != chunks.end(); ++it) {
+        const Chunk* chunk = it->second;
+        for (int r = 0; r < kChunkSize; r++) {
+            for (uint64_t word = chunk->planes[phase][r]; word != 0; word &= word - 1) {
+                int c = lowestBit(word);
+                LifeCell cell = { chunk->chunkRow * kChunkSize + r, chunk->chunkCol * kChunkSize + c,
+                                  chunk->ages[r * kChunkSize + c] };
+                cells.push_back(cell);
+            }
+        }
+    }
+}
+
+bool ChunkLifeEngine::setRule(const LifeRule& newRule) {
+    rule = newRule;
+#define LIFE_SELECT_RULE(B, S) \
+    if (rule.birth == (B) && rule.survival == (S)) { \
+        stepper = &ChunkLifeEngine::stepChunk<(B), (S)>; \
+        return true; \
+    }
+    LIFE_SPECIALIZED_RULES(LIFE_SELECT_RULE)
+#undef LIFE_SELECT_RULE
+    stepper = &ChunkLifeEngine::stepChunk<kAnyRule, kAnyRule>;
+    return true;
+}
+
+uint64_t ChunkLifeEngine::keyOf(int chunkRow, int chunkCol) {
+    return (static_cast<uint64_t>(static_cast<uint32_t>(chunkRow)) << 32) | static_cast<uint32_t>(chunkCol);
+}
+
+/**
+ * Returns the chunk index of a row or column, rounding toward negative
+ * infinity so that cells at negative coordinates land in negative chunks.
+ */
+int ChunkLifeEngine::chunkOf(int coord) {
+    return (coord >= 0) ? coord / kChunkSize : -((-coord + kChunkSize - 1) / kChunkSize);
+}
+
+const ChunkLifeEngine::Chunk* ChunkLifeEngine::find(int chunkRow, int chunkCol) const {
+    ChunkMap::const_iterator found = chunks.find(keyOf(chunkRow, chunkCol));
+    return (found != chunks.end()) ? found->second : &emptyChunk;
+}
+
+/**
+ * Returns a zeroed chunk at the given position and adds it to the table.
+ */
+ChunkLifeEngine::Chunk* ChunkLifeEngine::allocate(int chunkRow, int chunkCol) {
+    Chunk* chunk;
+    if (spareChunks.empty()) {
+        chunk = new Chunk;
+    } else {
+        chunk = spareChunks.back();
+        spareChunks.pop_back();
+    }
+    memset(chunk, 0, sizeof(Chunk));
+    chunk->chunkRow = chunkRow;
+    chunk->chunkCol = chunkCol;
+    chunk->hash = cellHash(chunkRow * kChunkSize, chunkCol * kChunkSize);
+    chunks[keyOf(chunkRow, chunkCol)] = chunk;
+    return chunk;
+}
+
+/**
+ * Returns an emptied chunk to the spare pool, or deletes it if the pool is
+ * full, so that memory shrinks again once the colony does.
+ */
+void ChunkLifeEngine::release(Chunk* chunk) {
+    if (spareChunks.size() < kMaxSpareChunks) {
+        spareChunks.push_back(chunk);
+    } else {
+        delete chunk;
+    }
+}
+
+/**
+ * Writes the chunk's next plane from the current planes of it and its
+ * eight neighbors, updates its ages, records whether it will be empty and
+ * adds its births, deaths and live rows and columns to the outline and
+ * the counts.
+ * Returns true if any age changed.
+ */
+template <unsigned int Birth, unsigned int Survival>
+bool ChunkLifeEngine::stepChunk(Chunk* chunk) {
+    const int last = kChunkSize - 1;
+    const uint64_t* self = chunk->planes[phase];
+    const uint64_t* north = find(chunk->chunkRow - 1, chunk->chunkCol)->planes[phase];
+    const uint64_t* south = find(chunk->chunkRow + 1, chunk->chunkCol)->planes[phase];
+    const uint64_t* west = find(chunk->chunkRow, chunk->chunkCol - 1)->planes[phase];
+    const uint64_t* east = find(chunk->chunkRow, chunk->chunkCol + 1)->planes[phase];
+    uint64_t northWest = find(chunk->chunkRow - 1, chunk->chunkCol - 1)->planes[phase][last];
+    uint64_t northEast = find(chunk->chunkRow - 1, chunk->chunkCol + 1)->planes[phase][last];
+    uint64_t southWest = find(chunk->chunkRow + 1, chunk->chunkCol - 1)->planes[phase][0];
+    uint64_t southEast = find(chunk->chunkRow + 1, chunk->chunkCol + 1)->planes[phase][0];
+    uint64_t* out = chunk->planes[1 - phase];
+
+    bool changed = false;
+    uint64_t any = 0;
+    int firstRow = -1;
+    int lastRow = -1;
+    uint64_t rowHash = chunk->hash;
+    uint64_t hash = 0;
+    long long births = 0;
+    long long deaths = 0;
+    for (int r = 0; r < kChunkSize; r++) {
+        uint64_t up = (r == 0) ? north[last] : self[r - 1];
+        uint64_t upLeft = (r == 0) ? northWest : west[r - 1];
+        uint64_t upRight = (r == 0) ? northEast : east[r - 1];
+        uint64_t down = (r == last) ? south[0] : self[r + 1];
+        uint64_t downLeft = (r == last) ? southWest : west[r + 1];
+        uint64_t downRight = (r == last) ? southEast : east[r + 1];
+        uint64_t keep;
+        uint64_t grow;
+        stepWordRule<Birth, Survival>(upLeft, up, upRight, west[r], self[r], east[r],
+                                      downLeft, down, downRight, rule, keep, grow);
+
+        out[r] = grow | (keep & self[r]);
+        any |= out[r];
+        if (out[r] != 0) {
+            firstRow = (firstRow < 0) ? r : firstRow;
+            lastRow = r;
+        }
+        if ((self[r] | grow) != 0) {
+            uint64_t born = out[r] & ~self[r];
+            uint64_t died = self[r] & ~out[r];
+            if ((born | died) != 0) {
+                hash += rowHash * (wordHash(born, colHashes) - wordHash(died, colHashes));
+                births += bitCount(born);
+                deaths += bitCount(died);
+            }
+            uint8_t* cells = &chunk->ages[r * kChunkSize];
+            if (countingAges ? updateAgeBytes(cells, keep, grow, counts.ages) : updateAgeBytes(cells, keep, grow)) {
+                changed = true;
+            }
+        }
+        rowHash *= kRowHashBase;
+    }
+    chunk->emptyNext = (any == 0);
+    outline.hash += hash;
+    outline.population += births - deaths;
+    counts.births += births;
+    counts.deaths += deaths;
+    if (any != 0) {
+        outline.top = min(outline.top, chunk->chunkRow * kChunkSize + firstRow);
+        outline.bottom = max(outline.bottom, chunk->chunkRow * kChunkSize + lastRow + 1);
+        outline.left = min(outline.left, chunk->chunkCol * kChunkSize + lowestBit(any));
+        outline.right = max(outline.right, chunk->chunkCol * kChunkSize + highestBit(any) + 1);
+    }
+    return changed;
+}
+
+/**
+ * Brings the cell at (row, col) to life with the given age, allocating
+ * its chunk if needed.  Ages of 0 or less are skipped.
+ */
+void ChunkLifeEngine::setCell(int row, int col, int age) {
+    age = min(age, kMaxAge);
+    if (age <= 0) {
+        return;
+    }
+    int chunkRow = chunkOf(row);
+    int chunkCol = chunkOf(col);
+    ChunkMap::iterator found = chunks.find(keyOf(chunkRow, chunkCol));
+    Chunk* chunk = (found != chunks.end()) ? found->second : allocate(chunkRow, chunkCol);
+    row -= chunkRow * kChunkSize;
+    col -= chunkCol * kChunkSize;
+    chunk->planes[phase][row] |= 1ULL << col;
+    chunk->ages[row * kChunkSize + col] = static_cast<uint8_t>(age);
+}
+
+/**
+ * Rebuilds the outline from the current plane of every chunk, after cells
+ * were placed without stepping, and starts the counts over.
+ */
+void ChunkLifeEngine::traceOutline() {
+    memset(&outline, 0, sizeof(outline));
+    clearStats(counts);
+    countingAges = false;
+    if (chunks.empty()) {
+        return;
+    }
+    outline.top = INT_MAX;
+    outline.left = INT_MAX;
+    outline.bottom = INT_MIN;
+    outline.right = INT_MIN;
+    for (ChunkMap::const_iterator it = chunks.begin(); it != chunks.end(); ++it) {
+        const Chunk* chunk = it->second;
+        uint64_t rowHash = chunk->hash;
+        for (int r = 0; r < kChunkSize; r++) {
+            uint64_t word = chunk->planes[phase][r];
+            if (word != 0) {
+                int row = chunk->chunkRow * kChunkSize + r;
+                outline.top = min(outline.top, row);
+                outline.bottom = max(outline.bottom, row + 1);
+                outline.left = min(outline.left, chunk->chunkCol * kChunkSize + lowestBit(word));
+                outline.right = max(outline.right, chunk->chunkCol * kChunkSize + highestBit(word) + 1);
+                outline.hash += rowHash * wordHash(word, colHashes);
+                outline.population += bitCount(word);
+            }
+            rowHash *= kRowHashBase;
+        }
+    }
+}
+
+void ChunkLifeEngine::clearChunks() {
+    for (ChunkMap::iterator it = chunks.begin(); it != chunks.end(); ++it) {
+        release(it->second);
+    }
+    chunks.clear();
+}
@@ -0,0 +1,120 @@
+/**
+ * File: life-chunked.h
+ * --------------------
+ * Defines a Life engine for an unbounded universe.  Space is cut into
+ * 64 x 64 chunks kept in a hash table, and only chunks that hold live
+ * cells exist: a chunk is created when a birth spills into it and freed
+ * as soon as it empties, so memory grows with the live cells rather than
+ * with the area the colony has wandered over.
+ */
+
+#pragma once
+#include <cstdint>        // for uint64_t, uint8_t
+#include <string>         // for std::string
+#include <unordered_map>  // for std::unordered_map
+#include <vector>         // for std::vector
+#include "grid.h"         // for Grid
+
+#include "life-engine.h"
+
+class ChunkLifeEngine : public LifeEngine {
+public:
+/**
+ * Constructs an empty universe.
+ */
+    ChunkLifeEngine();
+
+/**
+ * Frees every chunk.
+ */
+    ~ChunkLifeEngine();
+
+    std::string name() const;
+
+/**
+ * Loads the board so that its cell (0, 0) sits at the universe's origin.
+ * The board's dimensions become the window reported by numRows, numCols
+ * and ageAt; cells outside of it are still simulated.
+ */
+    void load(const Grid<int>& board);
+    void loadCells(int numRows, int numCols, const std::vector<LifeCell>& cells);
+    bool step();
+    bool isBounded() const { return false; }
+    int numRows() const { return rows; }
+    int numCols() const { return cols; }
+    int ageAt(int row, int col) const;
+    long long population() const { return outline.population; }
+    void liveCells(std::vector<LifeCell>& cells) const;
+
+/**
+ * The counts cover every live cell, including those outside the window,
+ * as population does, and ages[0] is the window's area less the
+ * population, or 0 if more cells are alive than the window holds.
+ * Births and deaths are counted while stepping.  The first call after a
+ * load counts the ages, and from then on each step keeps them.
+ */
+    void stats(LifeStats& stats) const;
+
+/**
+ * Every chunk is visited each step, so the bounding box is gathered from
+ * the rows being written and the hash from the births and deaths among
+ * them, cells outside the window included.
+ */
+    void shape(LifeShape& shape) const { shape = outline; }
+    bool setRule(const LifeRule& newRule);
+
+/**
+ * Returns the number of chunks currently allocated.
+ */
+    int chunkCount() const { return static_cast<int>(chunks.size()); }
+
+private:
+    static const int kChunkSize = 64;
+
+    // freed chunks kept for reuse, since each step allocates and frees
+    // trial chunks along the colony's edge; the rest are deleted
+    static const std::size_t kMaxSpareChunks = 64;
+
+    struct Chunk {
+        int chunkRow;
+        int chunkCol;
+        std::uint64_t hash;                            // cellHash of the chunk's top-left cell
+        bool emptyNext;                                // no live cells in the plane being written
+        std::uint64_t planes[2][kChunkSize];           // bit c of plane[r] is cell (r, c)
+        std::uint8_t ages[kChunkSize * kChunkSize];    // row-major, one byte per cell
+    };
+
+    struct KeyHash {
+        std::size_t operator()(std::uint64_t key) const;
+    };
+
+    typedef std::unordered_map<std::uint64_t, Chunk*, KeyHash> ChunkMap;
+
+    int rows;
+    int cols;
+    int phase;                         // index of the current plane in every chunk
+    ChunkMap chunks;
+    std::vector<Chunk*> stepping;      // chunks that existed at the start of the step
+    std::vector<Chunk*> spareChunks;   // freed chunks kept for reuse, at most kMaxSpareChunks
+    Chunk emptyChunk;                  // stands in for chunks that do not exist
+    LifeShape outline;                 // updated by each step
+    mutable LifeStats counts;          // likewise, apart from population, ages[0] and the ages
+                                       // before countingAges is set
+    mutable bool countingAges;         // set by the first call to stats after a load
+    std::uint64_t colHashes[kChunkSize];   // hash of each cell in row 0 of chunk (0, 0)
+    LifeRule rule;
+    bool (ChunkLifeEngine::*stepper)(Chunk* chunk);   // stepChunk specialized for the rule
+
+    static std::uint64_t keyOf(int chunkRow, int chunkCol);
+    static int chunkOf(int coord);
+    const Chunk* find(int chunkRow, int chunkCol) const;
+    Chunk* allocate(int chunkRow, int chunkCol);
+    void release(Chunk* chunk);
+    template <unsigned int Birth, unsigned int Survival> bool stepChunk(Chunk* chunk);
+    void setCell(int row, int col, int age);
+    void traceOutline();
+    void clearChunks();
+
+    ChunkLifeEngine(const ChunkLifeEngine& original);
+    void operator=(const ChunkLifeEngine& rhs) const;
+};
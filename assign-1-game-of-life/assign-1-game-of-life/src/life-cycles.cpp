@@ -0,0 +1,59 @@
+/**
+ * File: life-cycles.cpp
+ * ---------------------
+ * Implements the cycle detector.  The table maps each hash to the latest
+ * generation it was seen in, so a match always reports the shortest
+ * period; the history queue evicts the oldest entries once the table is full.
+ */
+
+#include <algorithm>  // for max
+using namespace std;
+
+#include "life-cycles.h"
+#include "life-shape.h"   // for moveHash
+
+CycleDetector::CycleDetector(int capacity)
+        : capacity(max(1, capacity)), cyclePeriod(0), cycleGeneration(0),
+          cycleRowShift(0), cycleColShift(0) {
+    // empty
+}
+
+void CycleDetector::clear() {
+    seen.clear();
+    history.clear();
+    cyclePeriod = 0;
+    cycleGeneration = 0;
+    cycleRowShift = 0;
+    cycleColShift = 0;
+}
+
+bool CycleDetector::observe(const LifeEngine& engine, long long generation) {
+    LifeShape shape;
+    engine.shape(shape);
+    uint64_t hash = moveHash(shape.hash, -shape.top, -shape.left);
+    Sighting sighting = { generation, shape.population, shape.top, shape.left,
+                          shape.bottom - shape.top, shape.right - shape.left };
+
+    bool found = false;
+    unordered_map<uint64_t, Sighting>::iterator match = seen.find(hash);
+    if (match != seen.end() && match->second.population == sighting.population
+            && match->second.height == sighting.height && match->second.width == sighting.width) {
+        found = true;
+        cyclePeriod = generation - match->second.generation;
+        cycleGeneration = match->second.generation;
+        cycleRowShift = sighting.top - match->second.top;
+        cycleColShift = sighting.left - match->second.left;
+    }
+
+    seen[hash] = sighting;
+    history.push_back(make_pair(hash, generation));
+    while (static_cast<int>(history.size()) > capacity) {
+        // a hash seen again since this entry was queued has a newer entry behind it
+        unordered_map<uint64_t, Sighting>::iterator oldest = seen.find(history.front().first);
+        if (oldest != seen.end() && oldest->second.generation == history.front().second) {
+            seen.erase(oldest);
+        }
+        history.pop_front();
+    }
+    return found;
+}
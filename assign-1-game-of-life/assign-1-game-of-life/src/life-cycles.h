@@ -0,0 +1,84 @@
+/**
+ * File: life-cycles.h
+ * -------------------
+ * Defines a detector for colonies that have settled into a repeating
+ * cycle.  Each generation is reduced to a 64-bit hash of its live cells,
+ * and a bounded table of recent hashes is searched for an earlier match.
+ * Because the hash is measured from the pattern's bounding box, a
+ * spaceship that reappears somewhere else on the board is found too.
+ * The hash comes from the engine's LifeShape, which every engine keeps up
+ * to date as it steps, so observing a generation does not rescan it.
+ */
+
+#pragma once
+#include <cstdint>        // for uint64_t
+#include <deque>          // for std::deque
+#include <unordered_map>  // for std::unordered_map
+#include <utility>        // for std::pair
+
+#include "life-engine.h"
+
+class CycleDetector {
+public:
+/**
+ * Constructs a detector that remembers the hashes of the last capacity
+ * generations it has seen.  Cycles longer than that are not found.
+ */
+    explicit CycleDetector(int capacity = kDefaultCapacity);
+
+/**
+ * Forgets every generation seen so far, e.g. after loading a new board.
+ */
+    void clear();
+
+/**
+ * Records the engine's current colony as the given generation and returns
+ * true if the same live cells, possibly shifted, were seen before.  A
+ * match needs the same population and bounding box size as well as the
+ * same hash, so a hash collision alone does not end a run early.  The
+ * details of the most recent match are then available from the accessors
+ * below.  Ages are ignored, so an oscillator is found as soon as its cells
+ * repeat even while their colors are still catching up.
+ */
+    bool observe(const LifeEngine& engine, long long generation);
+
+/**
+ * Returns the number of generations between the two matching colonies, or
+ * 0 if no cycle has been found.  For engines that step several
+ * generations at once this is a multiple of the true period.
+ */
+    long long period() const { return cyclePeriod; }
+
+/**
+ * Returns the earlier generation of the most recent match.
+ */
+    long long cycleStart() const { return cycleGeneration; }
+
+/**
+ * Returns how far the colony moved over one period.  Both are 0 for an
+ * oscillator or still life and nonzero for a spaceship.
+ */
+    int rowShift() const { return cycleRowShift; }
+    int colShift() const { return cycleColShift; }
+    bool isMoving() const { return cycleRowShift != 0 || cycleColShift != 0; }
+
+    static const int kDefaultCapacity = 4096;
+
+private:
+    struct Sighting {
+        long long generation;
+        long long population;
+        int top;
+        int left;
+        int height;
+        int width;
+    };
+
+    int capacity;
+    std::unordered_map<std::uint64_t, Sighting> seen;             // latest sighting of each hash
+    std::deque<std::pair<std::uint64_t, long long> > history;   // hashes in the order seen
+    long long cyclePeriod;
+    long long cycleGeneration;
+    int cycleRowShift;
+    int cycleColShift;
+};
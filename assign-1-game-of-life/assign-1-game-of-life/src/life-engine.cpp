@@ -0,0 +1,309 @@
+/**
+ * File: life-engine.cpp
+ * ---------------------
+ * Implements the engine factory along with the original Grid<int>
+ * engine, which steps every cell by counting its neighbors one at a time.
+ */
+
+#include <algorithm>  // for min
+using namespace std;
+#include "error.h"    // for error
+
+#include "life-constants.h"  // for kMaxAge
+#include "life-engine.h"
+#include "life-shape.h"      // for ShapeTracker, scanShape, moveHash
+#include "life-bitboard.h"   // for BitLifeEngine
+#include "life-simd.h"       // for SimdLifeEngine
+#include "life-hashlife.h"   // for HashLifeEngine
+#include "life-active.h"     // for ActiveLifeEngine
+#include "life-parallel.h"   // for ParallelLifeEngine
+#include "life-chunked.h"    // for ChunkLifeEngine
+
+static void createCopy(const Grid<int>& grid, Grid<int>& gridCopy);
+
+static int countNeighbors(const Grid<int>& grid, const int row, const int col, bool wrap);
+
+static int nextGeneration(const Grid<int>& grid, int neighbors, int row, int col, const LifeRule& rule);
+
+static bool setNextGeneration(const Grid<int>& grid, Grid<int>& gridCopy, const int rows, const int cols, bool wrap,
+                              const LifeRule& rule, LifeStats& stats, ShapeTracker& outline);
+
+/**
+ * Class: GridLifeEngine
+ * ---------------------
+ * Stores one int per cell and steps the colony one cell at a time.
+ * This is the reference implementation the other engines must agree with.
+ */
+class GridLifeEngine : public LifeEngine {
+public:
+    GridLifeEngine() : wrapping(false), rule(kConwayRule) {
+        clearStats(counts);
+    }
+
+    string name() const { return "grid"; }
+
+    void load(const Grid<int>& grid) {
+        board.resize(grid.numRows(), grid.numCols());
+        clearStats(counts);
+        outline.reset(grid.numRows(), grid.numCols());
+        for (int i = 0; i < grid.numRows(); i++) {
+            for (int j = 0; j < grid.numCols(); j++) {
+                board.set(i, j, min(grid.get(i, j), kMaxAge));
+                counts.ages[board.get(i, j)]++;
+                if (board.get(i, j) > 0) {
+                    outline.add(i, j);
+                }
+            }
+        }
+        counts.population = static_cast<long long>(board.size()) - counts.ages[0];
+        createCopy(board, boardCopy);
+    }
+
+    bool step() {
+        bool changed = setNextGeneration(board, boardCopy, board.numRows(), board.numCols(), wrapping, rule, counts,
+                                         outline);
+        board.swap(boardCopy);
+        return changed;
+    }
+
+    long long population() const { return counts.population; }
+    void stats(LifeStats& stats) const { stats = counts; }
+    void shape(LifeShape& shape) const { outline.fill(shape); }
+
+    int numRows() const { return board.numRows(); }
+    int numCols() const { return board.numCols(); }
+    int ageAt(int row, int col) const { return board.get(row, col); }
+
+    bool setWrapping(bool wrap) {
+        wrapping = wrap;
+        return true;
+    }
+
+    bool setRule(const LifeRule& newRule) {
+        rule = newRule;
+        return true;
+    }
+
+private:
+    Grid<int> board;
+    Grid<int> boardCopy;
+    bool wrapping;
+    LifeRule rule;
+    LifeStats counts;       // kept up to date by setNextGeneration
+    ShapeTracker outline;   // likewise
+};
+
+void LifeEngine::loadCells(int rows, int cols, const vector<LifeCell>& cells) {
+    Grid<int> board(rows, cols);
+    for (size_t i = 0; i < cells.size(); i++) {
+        if (board.inBounds(cells[i].row, cells[i].col)) {
+            board.set(cells[i].row, cells[i].col, cells[i].age);
+        }
+    }
+    load(board);
+}
+
+void LifeEngine::liveCells(vector<LifeCell>& cells) const {
+    cells.clear();
+    for (int i = 0; i < numRows(); i++) {
+        for (int j = 0; j < numCols(); j++) {
+            int age = ageAt(i, j);
+            if (age > 0) {
+                LifeCell cell = { i, j, age };
+                cells.push_back(cell);
+            }
+        }
+    }
+}
+
+void LifeEngine::stats(LifeStats& stats) const {
+    clearStats(stats);
+    for (int i = 0; i < numRows(); i++) {
+        for (int j = 0; j < numCols(); j++) {
+            stats.ages[ageAt(i, j)]++;
+        }
+    }
+    stats.population = population();
+    stats.births = -1;
+    stats.deaths = -1;
+}
+
+void LifeEngine::store(Grid<int>& board) const {
+    board.resize(numRows(), numCols());
+    for (int i = 0; i < numRows(); i++) {
+        for (int j = 0; j < numCols(); j++) {
+            board.set(i, j, ageAt(i, j));
+        }
+    }
+}
+
+long long LifeEngine::population() const {
+    long long count = 0;
+    for (int i = 0; i < numRows(); i++) {
+        for (int j = 0; j < numCols(); j++) {
+            if (ageAt(i, j) > 0) {
+                count++;
+            }
+        }
+    }
+    return count;
+}
+
+void LifeEngine::shape(LifeShape& shape) const {
+    scanShape(*this, shape);
+}
+
+uint64_t LifeEngine::patternHash(int& top, int& left) const {
+    LifeShape current;
+    shape(current);
+    top = current.top;
+    left = current.left;
+    return moveHash(current.hash, -top, -left);
+}
+
+Vector<string> lifeEngineNames() {
+    Vector<string> names;
+    names.add("grid");
+    names.add("bitboard");
+    names.add("simd");
+    names.add("hashlife");
+    names.add("active");
+    names.add("parallel");
+    names.add("chunked");
+    return names;
+}
+
+LifeEngine* createLifeEngine(const string& name) {
+    if (name == "grid") {
+        return new GridLifeEngine;
+    } else if (name == "bitboard") {
+        return new BitLifeEngine;
+    } else if (name == "simd") {
+        return new SimdLifeEngine;
+    } else if (name == "hashlife") {
+        return new HashLifeEngine;
+    } else if (name == "active") {
+        return new ActiveLifeEngine;
+    } else if (name == "parallel") {
+        return new ParallelLifeEngine;
+    } else if (name == "chunked") {
+        return new ChunkLifeEngine;
+    }
+    error("createLifeEngine: unknown engine \"" + name + "\"");
+    return nullptr;
+}
+
+/**
+  * Function: createCopy
+  * -------------------
+  * Make copy of your grid
+  */
+static void createCopy(const Grid<int>& grid, Grid<int>& gridCopy) {
+    int rows = grid.numRows();
+    int cols = grid.numCols();
+
+    gridCopy.resize(rows, cols);
+
+    for (int i = 0; i < rows; i++) {
+        for (int j = 0; j < cols; j++) {
+            gridCopy.set(i,j,grid.get(i,j));
+        }
+    }
+}
+
+/**
+  * Function: countNeighbors
+  * ------------------------
+  * count number of element's neighbors.  If wrap is set, neighbors past
+  * an edge are taken from the opposite edge.
+  */
+static int countNeighbors(const Grid<int>& grid, const int row, const int col, bool wrap) {
+    int neighbors = 0;
+    for (int i = row-1; i < row+2; ++i) {
+        for (int j = col-1; j < col+2; ++j) {
+            int r = i;
+            int c = j;
+            if (wrap) {
+                r = (i + grid.numRows()) % grid.numRows();
+                c = (j + grid.numCols()) % grid.numCols();
+            }
+            if (grid.inBounds(r, c)) {
+                if (grid.get(r,c) > 0) {
+                    if (i == row && j == col) {
+                        neighbors += 0;
+                    }
+                    else {
+                        ++neighbors;
+                    }
+                }
+            }
+        }
+    }
+    return neighbors;
+}
+
+/**
+ * @brief nextGeneration
+ * @param grid
+ * @param neighbors
+ * @param row
+ * @param col
+ * @param rule
+ * @return
+ * ----------------------
+ * returns value of cell's next generation under the given rule
+ */
+static int nextGeneration(const Grid<int>& grid, int neighbors, int row, int col, const LifeRule& rule) {
+    return nextAge(rule, grid.get(row, col), neighbors);
+}
+
+/**
+ * @brief setNextGeneration
+ * @param grid
+ * @param gridCopy
+ * @param rows
+ * @param cols
+ * @param wrap
+ * @param rule
+ * @param stats
+ * @param outline
+ * @return
+ * Iterate through grid and set it's next generation value in gridCopy,
+ * counting the new generation's ages, births and deaths into stats and
+ * passing the births and deaths on to outline as it goes.  Returns true
+ * if any cell's value changed.
+ */
+static bool setNextGeneration(const Grid<int>& grid, Grid<int>& gridCopy, const int rows, const int cols, bool wrap,
+                              const LifeRule& rule, LifeStats& stats, ShapeTracker& outline) {
+    bool changed = false;
+    clearStats(stats);
+    for (int i = 0; i < rows; ++i) {
+        for (int j = 0; j < cols; ++j) {
+            int current = grid.get(i,j);
+            int next = nextGeneration(grid, countNeighbors(grid, i, j, wrap), i, j, rule);
+            if (next != current) {
+                changed = true;
+                if (current == 0) {
+                    stats.births++;
+                    outline.add(i, j);
+                } else if (next == 0) {
+                    stats.deaths++;
+                    outline.remove(i, j);
+                }
+            }
+            stats.ages[next]++;
+            gridCopy.set(i,j,next);
+        }
+    }
+    stats.population = static_cast<long long>(rows) * cols - stats.ages[0];
+    return changed;
+}
+
+void clearStats(LifeStats& stats) {
+    stats.population = 0;
+    stats.births = 0;
+    stats.deaths = 0;
+    for (int age = 0; age <= kMaxAge; age++) {
+        stats.ages[age] = 0;
+    }
+}
@@ -0,0 +1,185 @@
+/**
+ * File: life-engine.h
+ * -------------------
+ * Defines the interface shared by every Game of Life simulation engine,
+ * so that the driver in life.cpp can step and display a colony without
+ * knowing how a particular engine stores it.
+ */
+
+#pragma once
+#include <cstdint>   // for uint64_t
+#include <string>    // for std::string
+#include <vector>    // for std::vector
+#include "grid.h"    // for Grid
+#include "vector.h"  // for Vector
+
+#include "life-constants.h"  // for kMaxAge
+#include "life-rules.h"      // for LifeRule
+
+/**
+ * A live cell, as passed to LifeEngine::loadCells.
+ */
+struct LifeCell {
+    int row;
+    int col;
+    int age;
+};
+
+/**
+ * Counts describing the current generation, as filled in by
+ * LifeEngine::stats.
+ */
+struct LifeStats {
+    long long population;
+    long long births;               // cells born in the latest step, or -1 if not tracked
+    long long deaths;               // cells that died in the latest step, or -1 if not tracked
+    long long ages[kMaxAge + 1];    // cells on the board of each age; ages[0] counts dead cells
+};
+
+/**
+ * Zeroes every count in stats.
+ */
+void clearStats(LifeStats& stats);
+
+/**
+ * Where the live cells are and which cells they are, as filled in by
+ * LifeEngine::shape.
+ */
+struct LifeShape {
+    long long population;
+    int top;                        // first row and column holding a live cell
+    int left;
+    int bottom;                     // one past the last row and column holding one;
+    int right;                      // all four are 0 when there are no live cells
+    std::uint64_t hash;             // sum of cellHash over the live cells where they are
+};
+
+class LifeEngine {
+public:
+/**
+ * Destroys the engine along with any storage it owns.
+ */
+    virtual ~LifeEngine() {}
+
+/**
+ * Returns the short name used to select this engine (e.g. "grid").
+ */
+    virtual std::string name() const = 0;
+
+/**
+ * Replaces the engine's colony with the contents of the given board.
+ * Each entry is the age of the cell at that location, and 0 means the
+ * cell is dead.  Ages above kMaxAge are stored as kMaxAge.
+ */
+    virtual void load(const Grid<int>& board) = 0;
+
+/**
+ * Replaces the engine's colony with a rows x cols board that holds only
+ * the given live cells.  Cells outside the board are kept by unbounded
+ * engines and dropped by the others.  By default the whole board is built
+ * and passed to load; engines with sparse storage place the cells directly.
+ */
+    virtual void loadCells(int rows, int cols, const std::vector<LifeCell>& cells);
+
+/**
+ * Replaces the contents of cells with every live cell in the colony.
+ * Unbounded engines include cells that have left the board, so rows and
+ * columns may be negative.  By default every cell is scanned.
+ */
+    virtual void liveCells(std::vector<LifeCell>& cells) const;
+
+/**
+ * Advances the colony by a single generation.  Under Conway's rule, a
+ * cell with 2 neighbors keeps its age, a cell with 3 neighbors grows one
+ * generation older (saturating at kMaxAge), and every other cell dies.
+ * Returns true if any cell's age changed, and false once the colony has
+ * stabilized.
+ */
+    virtual bool step() = 0;
+
+/**
+ * Returns the dimensions of the colony.
+ */
+    virtual int numRows() const = 0;
+    virtual int numCols() const = 0;
+
+/**
+ * Returns the age of the cell at the specified location, or 0 if it is dead.
+ */
+    virtual int ageAt(int row, int col) const = 0;
+
+/**
+ * Switches to the given birth/survival rule for all later steps.  Every
+ * engine starts out with Conway's rule.  Returns false if this engine
+ * cannot simulate the rule, in which case nothing changes.
+ */
+    virtual bool setRule(const LifeRule& rule) { return rule == kConwayRule; }
+
+/**
+ * Selects whether the board wraps around at its edges like a torus, so
+ * that the top row neighbors the bottom row and the leftmost column
+ * neighbors the rightmost one.  Boards are bounded by default.  Returns
+ * false if this engine cannot wrap, in which case nothing changes.
+ */
+    virtual bool setWrapping(bool wrap) { return !wrap; }
+
+/**
+ * Returns the number of live cells.  By default every cell is scanned.
+ */
+    virtual long long population() const;
+
+/**
+ * Fills in stats for the current generation.  Births and deaths are 0
+ * right after a load.  Engines that track the counts update them while
+ * they step, so this costs almost nothing; some only start keeping the
+ * age counts once they have been asked for them, and count the board on
+ * that first call.  By default every cell is scanned instead, and births
+ * and deaths are reported as -1.
+ */
+    virtual void stats(LifeStats& stats) const;
+
+/**
+ * Fills in shape for the current generation.  Engines that track it add
+ * and subtract cells as they are born and die while stepping, so this
+ * costs almost nothing.  By default every cell is scanned instead.
+ */
+    virtual void shape(LifeShape& shape) const;
+
+/**
+ * Returns a 64-bit hash of which cells are alive, ignoring their ages.
+ * Cells are measured from the top-left corner of the live cells' bounding
+ * box, which is stored in top and left, so a pattern that has only moved
+ * hashes the same.  An empty colony hashes to 0 at (0, 0).  The hash is
+ * moved over from shape's, so it costs no more than shape does.
+ */
+    std::uint64_t patternHash(int& top, int& left) const;
+
+/**
+ * Returns false if the engine simulates an unbounded universe, where
+ * cells keep evolving after they leave the board instead of dying at its
+ * edge.  Such engines can disagree with bounded ones once a pattern
+ * reaches the edge.
+ */
+    virtual bool isBounded() const { return true; }
+
+/**
+ * Returns the number of generations that each call to step advances.
+ */
+    virtual long long stepSize() const { return 1; }
+
+/**
+ * Copies the colony's ages into board, resizing it as needed.
+ */
+    virtual void store(Grid<int>& board) const;
+};
+
+/**
+ * Returns the names of all available engines, in menu order.
+ */
+Vector<std::string> lifeEngineNames();
+
+/**
+ * Allocates a new engine with the given name.  The caller owns the result
+ * and must delete it.  If the name is not recognized, an error is thrown.
+ */
+LifeEngine* createLifeEngine(const std::string& name);
@@ -13,6 +13,7 @@
 #include <sstream>  // for ostringstream
 #include <iomanip>  // for setw, setfill
 #include <ios>      // for hex stream manipulator
+#include <cmath>    // for ceil, floor
 using namespace std;
 #include "random.h" // for randomInteger
 #include "strlib.h" // for integerToString
@@ -24,13 +25,15 @@ using namespace std;
 const string LifeDisplay::kDefaultWindowTitle("Game of Life");
 const double kWindowPadding = 5; // Margin from border of window to content area
 
-LifeDisplay::LifeDisplay() : window(kDisplayWidth, kDisplayHeight) {
+LifeDisplay::LifeDisplay() : window(kDisplayWidth, kDisplayHeight), numRows(0), numColumns(0), pixelMode(false),
+                             viewportMode(false), viewTop(0), viewLeft(0), viewZoom(1) {
     initializeColors();
     window.setVisible(true);
     window.setWindowTitle(kDefaultWindowTitle);
     window.setRepaintImmediately(false);
     window.setAutoRepaint(false);
     window.setExitOnClose(true);
+    window.setKeyListener([this](GEvent event) { handleKey(event); });
 }
 
 LifeDisplay::~LifeDisplay() {
@@ -53,16 +56,264 @@ void LifeDisplay::fillCellGrid() {
     });
 }
 
+/**
+ * Works out which window pixels each cell covers and paints the empty
+ * board and its border into the pixel image.  Cells smaller than a pixel
+ * still get one pixel, so neighboring cells may share it; fillCellPixels
+ * then shades it from all of them.
+ */
+void LifeDisplay::fillPixelGrid() {
+    int width = static_cast<int>(window.getCanvasWidth());
+    int height = static_cast<int>(window.getCanvasHeight());
+    pixels.resize(height, width);
+    pixels.fill(rgbColors[0]);
+
+    int inset = (cellDiameter >= 3) ? 1 : 0;
+    rowTop.clear();
+    rowBottom.clear();
+    for (int r = 0; r < numRows; ++r) {
+        int top = static_cast<int>(upperLeftY + r * cellDiameter) + inset;
+        rowTop.add(min(top, height - 1));
+        rowBottom.add(min(max(top + 1, static_cast<int>(upperLeftY + (r + 1) * cellDiameter) - inset), height));
+    }
+    colLeft.clear();
+    colRight.clear();
+    for (int c = 0; c < numColumns; ++c) {
+        int left = static_cast<int>(upperLeftX + c * cellDiameter) + inset;
+        colLeft.add(min(left, width - 1));
+        colRight.add(min(max(left + 1, static_cast<int>(upperLeftX + (c + 1) * cellDiameter) - inset), width));
+    }
+
+    int right = min(static_cast<int>(upperLeftX + numColumns * cellDiameter) + 1, width - 1);
+    int bottom = min(static_cast<int>(upperLeftY + numRows * cellDiameter) + 1, height - 1);
+    int left = max(static_cast<int>(upperLeftX) - 1, 0);
+    int top = max(static_cast<int>(upperLeftY) - 1, 0);
+    for (int x = left; x <= right; ++x) {
+        pixels[top][x] = 0;
+        pixels[bottom][x] = 0;
+    }
+    for (int y = top; y <= bottom; ++y) {
+        pixels[y][left] = 0;
+        pixels[y][right] = 0;
+    }
+}
+
+/**
+ * Repaints the pixels of the cell at (row, column) from the ages already
+ * recorded.  Cells smaller than a pixel share it with their neighbors, so
+ * the pixel is shaded by the youngest live cell among all the cells that
+ * map onto it rather than by whichever cell was drawn last.
+ */
+void LifeDisplay::fillCellPixels(int row, int column) {
+    int age = ages[row][column];
+    if (cellDiameter < 1) {
+        int firstRow = row;
+        int lastRow = row;
+        while (firstRow > 0 && rowTop[firstRow - 1] == rowTop[row]) {
+            firstRow--;
+        }
+        while (lastRow + 1 < numRows && rowTop[lastRow + 1] == rowTop[row]) {
+            lastRow++;
+        }
+        int firstCol = column;
+        int lastCol = column;
+        while (firstCol > 0 && colLeft[firstCol - 1] == colLeft[column]) {
+            firstCol--;
+        }
+        while (lastCol + 1 < numColumns && colLeft[lastCol + 1] == colLeft[column]) {
+            lastCol++;
+        }
+        age = 0;
+        for (int r = firstRow; r <= lastRow; ++r) {
+            for (int c = firstCol; c <= lastCol; ++c) {
+                if (ages[r][c] > 0 && (age == 0 || ages[r][c] < age)) {
+                    age = ages[r][c];
+                }
+            }
+        }
+    }
+    for (int y = rowTop[row]; y < rowBottom[row]; ++y) {
+        for (int x = colLeft[column]; x < colRight[column]; ++x) {
+            pixels[y][x] = rgbColors[age];
+        }
+    }
+}
+
+/**
+ * Fills the pixel image with the part of the board in view.  Each window
+ * row and column is first mapped to the board row and column it starts
+ * at, so the per-pixel work is just a lookup or a small block count.
+ */
+void LifeDisplay::drawViewport(const vector<uint8_t>& boardAges) {
+    long long top;
+    long long left;
+    double zoom;
+    {
+        lock_guard<mutex> guard(viewLock);
+        top = viewTop;
+        left = viewLeft;
+        zoom = viewZoom;
+    }
+    int width = pixels.numCols();
+    int height = pixels.numRows();
+    long long block = (zoom >= 1) ? 1 : static_cast<long long>(ceil(1 / zoom));
+    long long stride = max(1LL, block / kMaxSamples);
+
+    vector<long long> firstRow(height);
+    for (int y = 0; y < height; ++y) {
+        firstRow[y] = top + ((zoom >= 1) ? static_cast<long long>(floor(y / zoom)) : y * block);
+    }
+    vector<long long> firstCol(width);
+    for (int x = 0; x < width; ++x) {
+        firstCol[x] = left + ((zoom >= 1) ? static_cast<long long>(floor(x / zoom)) : x * block);
+    }
+
+    for (int y = 0; y < height; ++y) {
+        long long rowStart = max(firstRow[y], 0LL);
+        long long rowEnd = min(firstRow[y] + block, static_cast<long long>(numRows));
+        for (int x = 0; x < width; ++x) {
+            long long colStart = max(firstCol[x], 0LL);
+            long long colEnd = min(firstCol[x] + block, static_cast<long long>(numColumns));
+            int rgb = kOffBoardColor;
+            if (rowStart >= rowEnd || colStart >= colEnd) {
+                // off the board
+            } else if (block == 1) {
+                rgb = rgbColors[min(static_cast<int>(boardAges[static_cast<size_t>(rowStart) * numColumns + colStart]),
+                                    kMaxAge)];
+            } else {
+                int live = 0;
+                int sampled = 0;
+                for (long long r = rowStart; r < rowEnd; r += stride) {
+                    const uint8_t* row = &boardAges[static_cast<size_t>(r) * numColumns];
+                    for (long long c = colStart; c < colEnd; c += stride) {
+                        if (row[c] > 0) {
+                            live++;
+                        }
+                        sampled++;
+                    }
+                }
+                // a full block is as dark as a newborn cell
+                rgb = rgbColors[(live == 0) ? 0 : kMaxAge - (live * (kMaxAge - 1) + sampled / 2) / sampled];
+            }
+            pixels[y][x] = rgb;
+        }
+    }
+}
+
+/**
+ * Pans and zooms the viewport.  Called on the GUI thread, so it only
+ * moves the view; the next drawBoard shows the result.
+ */
+void LifeDisplay::handleKey(GEvent event) {
+    if (!viewportMode || event.getEventType() != KEY_PRESSED) {
+        return;
+    }
+    lock_guard<mutex> guard(viewLock);
+    double cellsAcross = window.getCanvasWidth() / viewZoom;
+    double cellsDown = window.getCanvasHeight() / viewZoom;
+    long long centerRow = viewTop + static_cast<long long>(cellsDown / 2);
+    long long centerCol = viewLeft + static_cast<long long>(cellsAcross / 2);
+    switch (event.getKeyCode()) {
+        case GEvent::LEFT_ARROW_KEY:
+            viewLeft -= max(1LL, static_cast<long long>(cellsAcross / 4));
+            return;
+        case GEvent::RIGHT_ARROW_KEY:
+            viewLeft += max(1LL, static_cast<long long>(cellsAcross / 4));
+            return;
+        case GEvent::UP_ARROW_KEY:
+            viewTop -= max(1LL, static_cast<long long>(cellsDown / 4));
+            return;
+        case GEvent::DOWN_ARROW_KEY:
+            viewTop += max(1LL, static_cast<long long>(cellsDown / 4));
+            return;
+    }
+    char key = event.getKeyChar();
+    if ((key == '+' || key == '=') && viewZoom < kMaxZoom) {
+        viewZoom *= 2;
+    } else if ((key == '-' || key == '_') && viewZoom > 1.0 / kMaxZoom) {
+        viewZoom /= 2;
+    } else {
+        return;
+    }
+    // zoom about the center of the window
+    viewTop = centerRow - static_cast<long long>(window.getCanvasHeight() / viewZoom / 2);
+    viewLeft = centerCol - static_cast<long long>(window.getCanvasWidth() / viewZoom / 2);
+}
+
+void LifeDisplay::setViewport(int centerRow, int centerColumn, double pixelsPerCell) {
+    lock_guard<mutex> guard(viewLock);
+    viewportMode = (pixelsPerCell > 0);
+    viewZoom = viewportMode ? pixelsPerCell : 1;
+    viewTop = centerRow - static_cast<long long>(window.getCanvasHeight() / viewZoom / 2);
+    viewLeft = centerColumn - static_cast<long long>(window.getCanvasWidth() / viewZoom / 2);
+    numRows = 0; // force the next setDimensions to lay out the board again
+    numColumns = 0;
+}
+
+void LifeDisplay::drawBoard(const vector<uint8_t>& boardAges) {
+    if (boardAges.size() != static_cast<size_t>(numRows) * numColumns) {
+        error(string(__FUNCTION__) + " was given " + integerToString(static_cast<int>(boardAges.size())) +
+              " ages for a board of " + integerToString(numRows) + "x" + integerToString(numColumns) + ".");
+    }
+    if (viewportMode) {
+        drawViewport(boardAges);
+        return;
+    }
+    for (int r = 0; r < numRows; ++r) {
+        for (int c = 0; c < numColumns; ++c) {
+            drawCellAt(r, c, boardAges[static_cast<size_t>(r) * numColumns + c]);
+        }
+    }
+}
+
+void LifeDisplay::setPixelMode(bool enabled) {
+    if (enabled != pixelMode) {
+        pixelMode = enabled;
+        numRows = 0; // force the next setDimensions to lay out the board again
+        numColumns = 0;
+    }
+}
+
+void LifeDisplay::repaint() {
+    if (pixelMode || viewportMode) {
+        window.setPixels(pixels);
+    }
+    window.repaint();
+}
+
 void LifeDisplay::setDimensions(int numRows, int numColumns) {
     if (numRows <= 0 || numColumns <= 0) {
         error("LifeDisplay::setDimensions number of rows and columns must both be positive!");
     }
+
+    // the viewport image covers the whole window whatever the board size
+    if (viewportMode) {
+        if (numRows != this->numRows || numColumns != this->numColumns) {
+            this->numRows = numRows;
+            this->numColumns = numColumns;
+            ages.clear();
+            cells.clear();
+            window.clear();
+            pixels.resize(static_cast<int>(window.getCanvasHeight()), static_cast<int>(window.getCanvasWidth()));
+        }
+        return;
+    }
+
+    // same geometry as last time: keep the existing cells and their colors
+    if (numRows == this->numRows && numColumns == this->numColumns && !ages.isEmpty()) {
+        return;
+    }
     
     this->numRows = numRows;
     this->numColumns = numColumns;
     ages.resize(numRows, numColumns);
     computeGeometry();
     window.clear();
+    if (pixelMode) {
+        cells.clear();
+        fillPixelGrid();
+        return;
+    }
     fillCellGrid();
 
     window.setColor("White");
@@ -90,15 +341,24 @@ void LifeDisplay::drawCellAt(int row, int column, int age) {
               "drawing location (" + integerToString(row) + ", " + integerToString(column) + ").");
     }
     
+    if (viewportMode) {
+        error(string(__FUNCTION__) + " can't draw single cells in viewport mode; use drawBoard.");
+    }
+
     age = min(age, kMaxAge);
-    if (age == 0) {
+    if (ages[row][column] == age) {
+        return; // already drawn in this shade
+    }
+    ages[row][column] = age;
+    if (pixelMode) {
+        fillCellPixels(row, column);
+    } else if (age == 0) {
         cells[row][column]->setVisible(false);
     } else {
         cells[row][column]->setColor(colors[age]);
         cells[row][column]->setFillColor(colors[age]);
         cells[row][column]->setVisible(true);
     }
-    ages[row][column] = age;
 }
 
 int LifeDisplay::scalePrimaryColor(int baseContribution, int age) const {
@@ -109,6 +369,7 @@ int LifeDisplay::scalePrimaryColor(int baseContribution, int age) const {
 
 void LifeDisplay::initializeColors() {
     colors.add("White"); // colors[0] is used for age 0, and is always white
+    rgbColors.add(0xffffff);
     int baseColor[] = {
         randomInteger(0, 192), randomInteger(0, 192), randomInteger(0, 192)
     };
@@ -116,11 +377,14 @@ void LifeDisplay::initializeColors() {
     for (int age = 1; age <= kMaxAge; age++) {
         ostringstream oss;
         oss << "#";
+        int rgb = 0;
         for (int primary = 0; primary < 3; primary++) {
             int contribution = scalePrimaryColor(baseColor[primary], age);
             oss << setw(2) << setfill('0') << hex << contribution;
+            rgb = (rgb << 8) | contribution;
         }
         colors.add(oss.str());
+        rgbColors.add(rgb);
     }
 }
 
@@ -140,6 +404,9 @@ bool LifeDisplay::coordinateInRange(int row, int column) const {
 
 void LifeDisplay::printBoard() {
     cout << windowTitle << endl;
+    if (viewportMode) {
+        return; // only the pixels in view are kept
+    }
     for(int i = 0; i < numRows; ++i) {
         for(int j = 0; j < numColumns; ++j) {
             cout << setw(3) << setfill(' ') << ages[i][j];
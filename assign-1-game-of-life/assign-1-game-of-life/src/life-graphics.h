@@ -6,7 +6,11 @@
  */
 
 #pragma once
+#include <cstdint>   // for uint8_t
+#include <mutex>     // for std::mutex
 #include <string>    // for std::string
+#include <vector>    // for std::vector
+#include "gevent.h"  // for GEvent
 #include "gwindow.h" // for GWindow
 #include "vector.h"  // for Vector
 #include "grid.h"    // for Grid
@@ -34,13 +38,16 @@ public:
  * window.  The grid cells will be sized as large as will fit given
  * the grid geometry. Grids with more rows and columns will use smaller
  * cells. This function can be used at the beginning of a simulation or
- * between generations to clear the window before drawing the next generation.
+ * between generations.  If the dimensions match the current ones, the
+ * existing cells are kept as they are so that only cells whose age
+ * changes need to be redrawn.
  */
     void setDimensions(int rows, int cols);
     
  /**
   * Draws the cell at the specific row and column, replacing any previously
-  * drawn cell at that location.  Rows and columns are specified using zero-based
+  * drawn cell at that location.  Drawing a cell at the age it already shows
+  * does nothing.  Rows and columns are specified using zero-based
   * indexing and (0,0) is the upper-left corner. If the location given is not in bounds,
   * an error is thrown.
   *
@@ -56,10 +63,44 @@ public:
   */
     void drawCellAt(int row, int column, int age);
 
+ /**
+  * Chooses how cells are drawn.  By default each cell is its own GOval.
+  * In pixel mode, drawCellAt writes the cell's color straight into a single
+  * window-sized pixel image, which repaint copies to the window in one go,
+  * so the cost of a frame is bounded by the window size rather than the
+  * number of cells.  When cells are smaller than a pixel, each pixel takes
+  * the shade of the youngest live cell it covers, so a live cell never
+  * disappears behind a dead neighbor.  Takes effect at the next call to
+  * setDimensions.
+  */
+    void setPixelMode(bool enabled);
+
+ /**
+  * Switches to viewport mode, which shows only the part of the board that
+  * fits in the window, at pixelsPerCell pixels per cell and with cell
+  * (centerRow, centerColumn) in the middle.  Below one pixel per cell, each
+  * pixel covers a block of cells and is shaded by how many of them are
+  * alive, darkest when the block is full.  While viewport mode is on, the
+  * arrow keys pan by a quarter of the window and + and - zoom in and out.
+  * Viewport mode always draws into the pixel image and must be drawn with
+  * drawBoard.  Passing 0 for pixelsPerCell goes back to showing the whole
+  * board.  Takes effect at the next call to setDimensions.
+  */
+    void setViewport(int centerRow, int centerColumn, double pixelsPerCell);
+
+ /**
+  * Draws every cell of the board at once from ages, which holds the age of
+  * each cell row by row for the dimensions last passed to setDimensions.
+  * In viewport mode only the cells in view are read, and zoomed-out blocks
+  * are sampled, so the cost is bounded by the window size rather than the
+  * board size.  Otherwise each cell is drawn as by drawCellAt.
+  */
+    void drawBoard(const std::vector<std::uint8_t>& ages);
+
  /**
   * Repaints the graphics window.
   */
-    void repaint() { window.repaint(); }
+    void repaint();
 
  /**
   * Prints the current board with ages. Used for debugging and for
@@ -85,13 +126,30 @@ private:
     std::string windowTitle;
     Grid<int> ages;
     Grid<GOval*> cells; // to avoid redrawing duplicate cells
+    bool pixelMode;
+    Grid<int> pixels;               // window-sized image used in pixel mode
+    Vector<int> rgbColors;          // colors[age] as an RGB int
+    Vector<int> rowTop, rowBottom;  // pixel rows [top, bottom) covered by each cell row
+    Vector<int> colLeft, colRight;  // pixel columns [left, right) covered by each cell column
+    bool viewportMode;
+    std::mutex viewLock;            // the key listener moves the view from the GUI thread
+    long long viewTop;              // cell at the upper-left corner of the viewport
+    long long viewLeft;
+    double viewZoom;                // pixels per cell
     
     static const std::string kDefaultWindowTitle;
     static const int kDisplayWidth = 10 * 72; // 10 inches
     static const int kDisplayHeight = 7 * 72; // 7 inches
+    static const int kMaxSamples = 4;          // cells sampled per row and column of a zoomed-out pixel
+    static const int kOffBoardColor = 0xdddddd;
+    static const int kMaxZoom = 64;            // most pixels per cell, and the inverse of the fewest
     
     void initializeColors();
     void fillCellGrid();
+    void fillPixelGrid();
+    void fillCellPixels(int row, int column);
+    void drawViewport(const std::vector<std::uint8_t>& ages);
+    void handleKey(GEvent event);
     int scalePrimaryColor(int baseContribution, int age) const;
     void computeGeometry();
     bool coordinateInRange(int row, int column) const;
@@ -0,0 +1,525 @@
+/**
+ * File: life-hashlife.cpp
+ * -----------------------
+ * Implements the HashLife engine.  A node of level L covers a 2^L x 2^L
+ * square, and its result is the center 2^(L-1) x 2^(L-1) square advanced
+ * 2^min(k, L-2) generations, where k is the step exponent.  Identical
+ * squares share one node, so repeated structure is only simulated once.
+ */
+
+#include <algorithm>   // for min, max, partition
+#include <climits>     // for INT_MIN, INT_MAX
+#include <functional>  // for std::hash
+using namespace std;
+#include "error.h"     // for error
+
+#include "life-hashlife.h"
+#include "life-shape.h"    // for hashPower, kRowHashBase, kColHashBase
+
+static int clampToInt(long long value);
+
+bool HashLifeEngine::Quad::operator ==(const Quad& other) const {
+    return nw == other.nw && ne == other.ne && sw == other.sw && se == other.se;
+}
+
+size_t HashLifeEngine::QuadHash::operator ()(const Quad& quad) const {
+    hash<Node*> hasher;
+    size_t h = hasher(quad.nw);
+    h = h * 31 + hasher(quad.ne);
+    h = h * 31 + hasher(quad.sw);
+    h = h * 31 + hasher(quad.se);
+    return h ^ (h >> 17);
+}
+
+HashLifeEngine::HashLifeEngine()
+        : root(nullptr), rows(0), cols(0), stepExponent(0), generationCount(0), rule(kConwayRule) {
+    Outline cell = { 1, 0, 0, 1, 1 };
+    cellOutline = cell;
+    Node leaf = { nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, 0, 0, false };
+    deadLeaf = leaf;
+    liveLeaf = leaf;
+    liveLeaf.population = 1;
+    liveLeaf.outline = &cellOutline;
+    rowSpans[0] = kRowHashBase;
+    colSpans[0] = kColHashBase;
+    for (int level = 1; level < kMaxLevel; level++) {
+        rowSpans[level] = rowSpans[level - 1] * rowSpans[level - 1];
+        colSpans[level] = colSpans[level - 1] * colSpans[level - 1];
+    }
+    root = emptyNode(3);
+}
+
+HashLifeEngine::~HashLifeEngine() {
+    freeNodes();
+}
+
+string HashLifeEngine::name() const {
+    return "hashlife";
+}
+
+void HashLifeEngine::load(const Grid<int>& board) {
+    freeNodes();
+    rows = board.numRows();
+    cols = board.numCols();
+    generationCount = 0;
+
+    int level = 3;
+    while ((1LL << (level - 1)) < max(rows, cols)) {
+        level++;
+    }
+    long long half = 1LL << (level - 1);
+    root = build(board, level, -half, -half);
+}
+
+/**
+ * The universe is made just big enough to hold the board and every cell,
+ * which may lie outside of it.
+ */
+void HashLifeEngine::loadCells(int numRows, int numCols, const vector<LifeCell>& cells) {
+    freeNodes();
+    rows = numRows;
+    cols = numCols;
+    generationCount = 0;
+
+    vector<LifeCell> live;
+    long long extent = max(rows, cols);
+    for (size_t i = 0; i < cells.size(); i++) {
+        if (cells[i].age > 0) {
+            live.push_back(cells[i]);
+            long long row = cells[i].row;
+            long long col = cells[i].col;
+            extent = max(extent, max(row < 0 ? -row : row + 1, col < 0 ? -col : col + 1));
+        }
+    }
+    int level = 3;
+    while ((1LL << (level - 1)) < extent) {
+        level++;
+    }
+    long long half = 1LL << (level - 1);
+    root = buildCells(live.data(), live.data() + live.size(), level, -half, -half);
+}
+
+void HashLifeEngine::liveCells(vector<LifeCell>& cells) const {
+    cells.clear();
+    long long half = 1LL << (root->level - 1);
+    collectCells(root, -half, -half, cells);
+}
+
+bool HashLifeEngine::step() {
+    // grow the universe until it is deep enough for the jump and the whole
+    // pattern sits in the center quarter, so nothing can escape the result
+    while (root->level < stepExponent + 3 || centerOfCenter(root)->population != root->population) {
+        root = expand(root);
+    }
+    Node* before = root;
+    root = advance(root, stepExponent);
+    generationCount += stepSize();
+
+    Node* after = root;
+    while (after->level < before->level) {
+        after = expand(after);
+    }
+    bool changed = (after != before);
+
+    if (nodes.size() > kMaxNodes) {
+        collectGarbage();
+    }
+    return changed;
+}
+
+int HashLifeEngine::ageAt(int row, int col) const {
+    return isAlive(row, col) ? 1 : 0;
+}
+
+long long HashLifeEngine::population() const {
+    return root->population;
+}
+
+/**
+ * The root is centered on the origin, so its shape is moved up and left
+ * by half its size.
+ */
+void HashLifeEngine::shape(LifeShape& shape) const {
+    shape.population = root->population;
+    if (root->population == 0) {
+        shape.top = 0;
+        shape.left = 0;
+        shape.bottom = 0;
+        shape.right = 0;
+        shape.hash = 0;
+        return;
+    }
+    measure(root);
+    long long half = 1LL << (root->level - 1);
+    const Outline* outline = root->outline;
+    shape.hash = outline->hash * hashPower(kRowHashBase, -half) * hashPower(kColHashBase, -half);
+    shape.top = clampToInt(outline->top - half);
+    shape.left = clampToInt(outline->left - half);
+    shape.bottom = clampToInt(outline->bottom - half);
+    shape.right = clampToInt(outline->right - half);
+}
+
+long long HashLifeEngine::stepSize() const {
+    return 1LL << stepExponent;
+}
+
+void HashLifeEngine::setStepExponent(int exponent) {
+    if (exponent < 0 || exponent > kMaxStepExponent) {
+        error("HashLifeEngine::setStepExponent exponent must be between 0 and 48.");
+    }
+    if (exponent != stepExponent) {
+        stepExponent = exponent;
+        clearResults();
+    }
+}
+
+/**
+ * Remembered results were computed under the old rule, so they are dropped.
+ */
+bool HashLifeEngine::setRule(const LifeRule& newRule) {
+    if (newRule != rule) {
+        rule = newRule;
+        clearResults();
+    }
+    return true;
+}
+
+bool HashLifeEngine::isAlive(long long row, long long col) const {
+    long long half = 1LL << (root->level - 1);
+    row += half;
+    col += half;
+    if (row < 0 || col < 0 || row >= 2 * half || col >= 2 * half) {
+        return false;
+    }
+    const Node* node = root;
+    while (node->level > 0 && node->population > 0) {
+        half = 1LL << (node->level - 1);
+        if (row < half) {
+            node = (col < half) ? node->nw : node->ne;
+        } else {
+            node = (col < half) ? node->sw : node->se;
+            row -= half;
+        }
+        if (col >= half) {
+            col -= half;
+        }
+    }
+    return node == &liveLeaf;
+}
+
+/**
+ * Returns the unique node with the given quadrants, creating it if needed.
+ */
+HashLifeEngine::Node* HashLifeEngine::join(Node* nw, Node* ne, Node* sw, Node* se) {
+    Quad quad = { nw, ne, sw, se };
+    unordered_map<Quad, Node*, QuadHash>::iterator found = nodes.find(quad);
+    if (found != nodes.end()) {
+        return found->second;
+    }
+    Node* node;
+    if (spareNodes.empty()) {
+        nodePool.push_back(Node());
+        node = &nodePool.back();
+    } else {
+        node = spareNodes.back();
+        spareNodes.pop_back();
+    }
+    node->nw = nw;
+    node->ne = ne;
+    node->sw = sw;
+    node->se = se;
+    node->result = nullptr;
+    node->outline = nullptr;
+    node->population = nw->population + ne->population + sw->population + se->population;
+    node->level = nw->level + 1;
+    node->marked = false;
+    nodes[quad] = node;
+    return node;
+}
+
+/**
+ * Gives a node with live cells, and every such node below it that lacks
+ * one, its outline.  Each is built from the outlines of the quadrants with
+ * live cells, moved to where the quadrant sits inside the node.
+ */
+void HashLifeEngine::measure(Node* node) const {
+    if (node->outline != nullptr) {
+        return;
+    }
+    Outline* outline;
+    if (spareOutlines.empty()) {
+        outlines.push_back(Outline());
+        outline = &outlines.back();
+    } else {
+        outline = spareOutlines.back();
+        spareOutlines.pop_back();
+    }
+    int level = node->level - 1;
+    long long half = 1LL << level;
+    bool empty = true;
+    Node* quadrants[] = { node->nw, node->ne, node->sw, node->se };
+    for (int q = 0; q < 4; q++) {
+        if (quadrants[q]->population == 0) {
+            continue;
+        }
+        measure(quadrants[q]);
+        const Outline* part = quadrants[q]->outline;
+        long long top = (q / 2) * half;
+        long long left = (q % 2) * half;
+        uint64_t move = ((q / 2) ? rowSpans[level] : 1) * ((q % 2) ? colSpans[level] : 1);
+        outline->hash = (empty ? 0 : outline->hash) + part->hash * move;
+        outline->top = empty ? top + part->top : min(outline->top, top + part->top);
+        outline->left = empty ? left + part->left : min(outline->left, left + part->left);
+        outline->bottom = empty ? top + part->bottom : max(outline->bottom, top + part->bottom);
+        outline->right = empty ? left + part->right : max(outline->right, left + part->right);
+        empty = false;
+    }
+    node->outline = outline;
+}
+
+HashLifeEngine::Node* HashLifeEngine::emptyNode(int level) {
+    if (emptyNodes.empty()) {
+        emptyNodes.push_back(&deadLeaf);
+    }
+    while (static_cast<int>(emptyNodes.size()) <= level) {
+        Node* smaller = emptyNodes.back();
+        emptyNodes.push_back(join(smaller, smaller, smaller, smaller));
+    }
+    return emptyNodes[level];
+}
+
+/**
+ * Returns a node one level larger with the given node in its center.
+ */
+HashLifeEngine::Node* HashLifeEngine::expand(Node* node) {
+    Node* border = emptyNode(node->level - 1);
+    return join(join(border, border, border, node->nw),
+                join(border, border, node->ne, border),
+                join(border, node->sw, border, border),
+                join(node->se, border, border, border));
+}
+
+/**
+ * Returns the center half of a node, one level smaller.
+ */
+HashLifeEngine::Node* HashLifeEngine::center(Node* node) {
+    return join(node->nw->se, node->ne->sw, node->sw->ne, node->se->nw);
+}
+
+/**
+ * Returns the node straddling the border between two side-by-side nodes.
+ */
+HashLifeEngine::Node* HashLifeEngine::horizontalCenter(Node* west, Node* east) {
+    return join(west->ne, east->nw, west->se, east->sw);
+}
+
+/**
+ * Returns the node straddling the border between two stacked nodes.
+ */
+HashLifeEngine::Node* HashLifeEngine::verticalCenter(Node* north, Node* south) {
+    return join(north->sw, north->se, south->nw, south->ne);
+}
+
+/**
+ * Returns the center quarter of a node, two levels smaller.
+ */
+HashLifeEngine::Node* HashLifeEngine::centerOfCenter(Node* node) {
+    return join(node->nw->se->se, node->ne->sw->sw, node->sw->ne->ne, node->se->nw->nw);
+}
+
+/**
+ * Advances the center 2x2 of a 4x4 node by one generation, cell by cell.
+ */
+HashLifeEngine::Node* HashLifeEngine::advanceLevel2(Node* node) {
+    bool alive[4][4];
+    Node* quadrants[] = { node->nw, node->ne, node->sw, node->se };
+    for (int q = 0; q < 4; q++) {
+        int top = (q / 2) * 2;
+        int left = (q % 2) * 2;
+        alive[top][left] = quadrants[q]->nw == &liveLeaf;
+        alive[top][left + 1] = quadrants[q]->ne == &liveLeaf;
+        alive[top + 1][left] = quadrants[q]->sw == &liveLeaf;
+        alive[top + 1][left + 1] = quadrants[q]->se == &liveLeaf;
+    }
+
+    Node* next[2][2];
+    for (int row = 1; row <= 2; row++) {
+        for (int col = 1; col <= 2; col++) {
+            int neighbors = 0;
+            for (int i = row - 1; i <= row + 1; i++) {
+                for (int j = col - 1; j <= col + 1; j++) {
+                    if ((i != row || j != col) && alive[i][j]) {
+                        neighbors++;
+                    }
+                }
+            }
+            unsigned int counts = alive[row][col] ? rule.survival : rule.birth;
+            bool lives = (counts >> neighbors) & 1;
+            next[row - 1][col - 1] = lives ? &liveLeaf : &deadLeaf;
+        }
+    }
+    return join(next[0][0], next[0][1], next[1][0], next[1][1]);
+}
+
+/**
+ * Returns the center of a node of level L advanced 2^exponent generations,
+ * where exponent <= L - 2.  When exponent == L - 2 the node is advanced in
+ * two half-jumps; otherwise the first stage only recenters.
+ */
+HashLifeEngine::Node* HashLifeEngine::advance(Node* node, int exponent) {
+    if (node->population == 0) {
+        return emptyNode(node->level - 1);
+    }
+    if (node->result != nullptr) {
+        return node->result;
+    }
+    if (node->level == 2) {
+        node->result = advanceLevel2(node);
+        return node->result;
+    }
+
+    Node* parts[3][3] = {
+        { node->nw, horizontalCenter(node->nw, node->ne), node->ne },
+        { verticalCenter(node->nw, node->sw), center(node), verticalCenter(node->ne, node->se) },
+        { node->sw, horizontalCenter(node->sw, node->se), node->se }
+    };
+    bool fullSpeed = (exponent == node->level - 2);
+    int nextExponent = fullSpeed ? exponent - 1 : exponent;
+    for (int i = 0; i < 3; i++) {
+        for (int j = 0; j < 3; j++) {
+            parts[i][j] = fullSpeed ? advance(parts[i][j], nextExponent) : center(parts[i][j]);
+        }
+    }
+
+    node->result = join(advance(join(parts[0][0], parts[0][1], parts[1][0], parts[1][1]), nextExponent),
+                        advance(join(parts[0][1], parts[0][2], parts[1][1], parts[1][2]), nextExponent),
+                        advance(join(parts[1][0], parts[1][1], parts[2][0], parts[2][1]), nextExponent),
+                        advance(join(parts[1][1], parts[1][2], parts[2][1], parts[2][2]), nextExponent));
+    return node->result;
+}
+
+/**
+ * Builds the node for the square of the given level whose upper-left cell
+ * is (top, left) in board coordinates.  Cells off the board are dead.
+ */
+HashLifeEngine::Node* HashLifeEngine::build(const Grid<int>& board, int level, long long top, long long left) {
+    long long size = 1LL << level;
+    if (top + size <= 0 || left + size <= 0 || top >= rows || left >= cols) {
+        return emptyNode(level);
+    }
+    if (level == 0) {
+        return (board.get(top, left) > 0) ? &liveLeaf : &deadLeaf;
+    }
+    long long half = size / 2;
+    return join(build(board, level - 1, top, left),
+                build(board, level - 1, top, left + half),
+                build(board, level - 1, top + half, left),
+                build(board, level - 1, top + half, left + half));
+}
+
+/**
+ * Builds the node whose top-left corner is at (top, left) from the live
+ * cells in [first, last), which all lie inside it.  The cells are
+ * reordered as they are split among the quadrants.
+ */
+HashLifeEngine::Node* HashLifeEngine::buildCells(LifeCell* first, LifeCell* last, int level,
+                                                 long long top, long long left) {
+    if (first == last) {
+        return emptyNode(level);
+    }
+    if (level == 0) {
+        return &liveLeaf;
+    }
+    long long midRow = top + (1LL << (level - 1));
+    long long midCol = left + (1LL << (level - 1));
+    LifeCell* south = partition(first, last, [midRow](const LifeCell& cell) { return cell.row < midRow; });
+    LifeCell* northEast = partition(first, south, [midCol](const LifeCell& cell) { return cell.col < midCol; });
+    LifeCell* southEast = partition(south, last, [midCol](const LifeCell& cell) { return cell.col < midCol; });
+    return join(buildCells(first, northEast, level - 1, top, left),
+                buildCells(northEast, south, level - 1, top, midCol),
+                buildCells(south, southEast, level - 1, midRow, left),
+                buildCells(southEast, last, level - 1, midRow, midCol));
+}
+
+/**
+ * Appends the live cells of the node whose top-left corner is at
+ * (top, left).  Cells too far away to number with an int are skipped.
+ */
+void HashLifeEngine::collectCells(const Node* node, long long top, long long left, vector<LifeCell>& cells) const {
+    if (node->population == 0) {
+        return;
+    }
+    if (node->level == 0) {
+        if (top >= INT_MIN && top <= INT_MAX && left >= INT_MIN && left <= INT_MAX) {
+            LifeCell cell = { static_cast<int>(top), static_cast<int>(left), 1 };
+            cells.push_back(cell);
+        }
+        return;
+    }
+    long long half = 1LL << (node->level - 1);
+    collectCells(node->nw, top, left, cells);
+    collectCells(node->ne, top, left + half, cells);
+    collectCells(node->sw, top + half, left, cells);
+    collectCells(node->se, top + half, left + half, cells);
+}
+
+void HashLifeEngine::clearResults() {
+    for (unordered_map<Quad, Node*, QuadHash>::iterator it = nodes.begin(); it != nodes.end(); ++it) {
+        it->second->result = nullptr;
+    }
+}
+
+/**
+ * Frees every node that the root and the empty nodes do not reach, and
+ * keeps it and its outline for reuse.  Memoized results are dropped first
+ * since they may point at such nodes.
+ */
+void HashLifeEngine::collectGarbage() {
+    clearResults();
+    mark(root);
+    for (size_t i = 0; i < emptyNodes.size(); i++) {
+        mark(emptyNodes[i]);
+    }
+    for (unordered_map<Quad, Node*, QuadHash>::iterator it = nodes.begin(); it != nodes.end(); ) {
+        if (it->second->marked) {
+            it->second->marked = false;
+            ++it;
+        } else {
+            if (it->second->outline != nullptr) {
+                spareOutlines.push_back(it->second->outline);
+            }
+            spareNodes.push_back(it->second);
+            it = nodes.erase(it);
+        }
+    }
+}
+
+void HashLifeEngine::mark(Node* node) {
+    if (node->level == 0 || node->marked) {
+        return;
+    }
+    node->marked = true;
+    mark(node->nw);
+    mark(node->ne);
+    mark(node->sw);
+    mark(node->se);
+}
+
+void HashLifeEngine::freeNodes() {
+    nodes.clear();
+    nodePool.clear();
+    spareNodes.clear();
+    outlines.clear();
+    spareOutlines.clear();
+    emptyNodes.clear();
+    root = nullptr;
+}
+
+/**
+ * Function: clampToInt
+ * --------------------
+ * Returns the int closest to value.
+ */
+static int clampToInt(long long value) {
+    return static_cast<int>(max<long long>(INT_MIN, min<long long>(INT_MAX, value)));
+}
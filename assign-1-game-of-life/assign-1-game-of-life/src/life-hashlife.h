@@ -0,0 +1,167 @@
+/**
+ * File: life-hashlife.h
+ * ---------------------
+ * Defines a HashLife engine, which stores the colony as a quadtree of
+ * shared, hash-consed nodes and memoizes the future of every node it has
+ * seen.  Each step can jump 2^k generations at once, and the universe is
+ * unbounded: patterns keep evolving after they leave the loaded board.
+ *
+ * HashLife only tracks whether cells are alive, so every live cell is
+ * reported with age 1.
+ */
+
+#pragma once
+#include <cstdint>        // for uint64_t
+#include <deque>          // for std::deque
+#include <string>         // for std::string
+#include <unordered_map>  // for std::unordered_map
+#include <vector>         // for std::vector
+#include "grid.h"         // for Grid
+
+#include "life-engine.h"
+
+class HashLifeEngine : public LifeEngine {
+public:
+/**
+ * Constructs an empty universe that advances one generation per step.
+ */
+    HashLifeEngine();
+
+/**
+ * Frees every node in the universe.
+ */
+    ~HashLifeEngine();
+
+    std::string name() const;
+
+/**
+ * Loads the board so that its cell (0, 0) sits at the universe's origin.
+ * The board's dimensions become the window reported by numRows, numCols
+ * and ageAt; cells outside of it are still simulated.
+ */
+    void load(const Grid<int>& board);
+    void loadCells(int numRows, int numCols, const std::vector<LifeCell>& cells);
+    void liveCells(std::vector<LifeCell>& cells) const;
+
+/**
+ * Advances the universe by 2^k generations, where k is the step exponent.
+ * Returns false if the universe did not change.
+ */
+    bool step();
+
+    bool isBounded() const { return false; }
+    int numRows() const { return rows; }
+    int numCols() const { return cols; }
+    int ageAt(int row, int col) const;
+    long long population() const;
+
+/**
+ * The shape covers every live cell in the universe, not just the window,
+ * so patterns that have left the board still compare equal.  Nodes keep
+ * the shape of their own cells once it has been asked for, built from
+ * their quadrants', so reading it only visits the nodes created since it
+ * was last read.  Cells too far away to number with an int still count
+ * toward the population and hash, but the bounding box stops at an int's
+ * range.
+ */
+    void shape(LifeShape& shape) const;
+    long long stepSize() const;
+    bool setRule(const LifeRule& newRule);
+
+/**
+ * Sets the number of generations each call to step advances to 2^exponent.
+ * The exponent must be between 0 and kMaxStepExponent.  A jump of 2^k
+ * generations can carry cells 2^k cells away, and the universe is grown a
+ * few levels past that before each step, so the bound keeps coordinates,
+ * node sizes and the generation count comfortably inside 64 bits.
+ */
+    void setStepExponent(int exponent);
+    static const int kMaxStepExponent = 48;
+
+/**
+ * Returns the number of generations simulated since the last load.
+ */
+    long long generation() const { return generationCount; }
+
+/**
+ * Returns the state of any cell in the universe, with rows and columns
+ * numbered relative to the loaded board (both may be negative).
+ */
+    bool isAlive(long long row, long long col) const;
+
+private:
+    struct Outline {
+        std::uint64_t hash;   // sum of cellHash over the live cells, measured from the node's corner
+        long long top;        // bounding box of the live cells, measured likewise
+        long long left;
+        long long bottom;
+        long long right;
+    };
+
+    struct Node {
+        Node* nw;
+        Node* ne;
+        Node* sw;
+        Node* se;
+        Node* result;         // center advanced 2^stepExponent generations, once known
+        Outline* outline;     // shape of the live cells once measured; null while there are none
+        long long population;
+        int level;            // the node covers a 2^level x 2^level square
+        bool marked;          // scratch flag for garbage collection
+    };
+
+    struct Quad {
+        Node* nw;
+        Node* ne;
+        Node* sw;
+        Node* se;
+        bool operator ==(const Quad& other) const;
+    };
+
+    struct QuadHash {
+        std::size_t operator ()(const Quad& quad) const;
+    };
+
+    static const int kMaxLevel = 64;   // nodes this large would overflow a long long's coordinates
+
+    Node deadLeaf;
+    Node liveLeaf;
+    Outline cellOutline;             // the live leaf's
+    std::unordered_map<Quad, Node*, QuadHash> nodes;
+    std::deque<Node> nodePool;       // storage for the nodes, so they stay packed together
+    std::vector<Node*> spareNodes;   // nodes freed by garbage collection, kept for reuse
+    std::vector<Node*> emptyNodes;   // emptyNodes[level] is the all-dead node of that level
+    Node* root;                      // centered on the origin
+    int rows;
+    int cols;
+    int stepExponent;
+    long long generationCount;
+    LifeRule rule;
+    std::uint64_t rowSpans[kMaxLevel];   // kRowHashBase^(2^level), which moves a hash down 2^level rows
+    std::uint64_t colSpans[kMaxLevel];   // kColHashBase^(2^level), which moves it right 2^level columns
+    mutable std::deque<Outline> outlines;          // storage for the outlines, kept apart from the nodes
+    mutable std::vector<Outline*> spareOutlines;   // outlines of freed nodes, kept for reuse
+
+    Node* join(Node* nw, Node* ne, Node* sw, Node* se);
+    void measure(Node* node) const;
+    Node* emptyNode(int level);
+    Node* expand(Node* node);
+    Node* center(Node* node);
+    Node* horizontalCenter(Node* west, Node* east);
+    Node* verticalCenter(Node* north, Node* south);
+    Node* centerOfCenter(Node* node);
+    Node* advanceLevel2(Node* node);
+    Node* advance(Node* node, int exponent);
+    Node* build(const Grid<int>& board, int level, long long top, long long left);
+    Node* buildCells(LifeCell* first, LifeCell* last, int level, long long top, long long left);
+    void collectCells(const Node* node, long long top, long long left, std::vector<LifeCell>& cells) const;
+    void clearResults();
+    void collectGarbage();
+    void mark(Node* node);
+    void freeNodes();
+
+    static const std::size_t kMaxNodes = 1 << 22;
+
+    HashLifeEngine(const HashLifeEngine& original);
+    void operator=(const HashLifeEngine& rhs) const;
+};
@@ -0,0 +1,272 @@
+/**
+ * File: life-parallel.cpp
+ * -----------------------
+ * Implements the multithreaded Life engine.  Every step reads the current
+ * plane and writes the scratch plane, so a tile's halo rows and columns
+ * are simply read from its neighbors' cells in the current plane and
+ * tiles never need to wait for each other.  The calling thread works as
+ * worker 0 while the pool threads take the rest of the queues.
+ */
+
+#include <algorithm>  // for min, max, fill
+using namespace std;
+
+#include "life-constants.h"  // for kMaxAge
+#include "life-parallel.h"
+
+ParallelLifeEngine::ParallelLifeEngine(int threadCount)
+        : rows(0), cols(0), rowStride(2), tileRows(0), tileCols(0), countingAges(false), wrapping(false),
+          rule(kConwayRule), epoch(0), running(0), quitting(false), changed(false) {
+    clearStats(counts);
+    kernel = SimdLifeEngine::selectKernel(kernelType, rule);
+    startWorkers(threadCount);
+}
+
+ParallelLifeEngine::~ParallelLifeEngine() {
+    stopWorkers();
+}
+
+string ParallelLifeEngine::name() const {
+    return "parallel";
+}
+
+void ParallelLifeEngine::load(const Grid<int>& board) {
+    rows = board.numRows();
+    cols = board.numCols();
+    rowStride = cols + 2;
+    tileRows = (rows + kTileHeight - 1) / kTileHeight;
+    tileCols = (cols + kTileWidth - 1) / kTileWidth;
+    ages.assign(static_cast<size_t>(rows + 2) * rowStride, 0);
+    next.assign(ages.size(), 0);
+    outline.reset(rows, cols);
+    clearStats(counts);
+    countingAges = false;
+    for (int r = 0; r < rows; r++) {
+        for (int c = 0; c < cols; c++) {
+            ages[indexOf(r, c)] = static_cast<uint8_t>(max(0, min(board.get(r, c), kMaxAge)));
+            if (ages[indexOf(r, c)] > 0) {
+                outline.add(r, c);
+            }
+        }
+    }
+    resetChanges();
+}
+
+bool ParallelLifeEngine::step() {
+    if (wrapping) {
+        SimdLifeEngine::fillBorder(ages, rows, cols, true);
+    }
+
+    // deal out contiguous runs of tiles so neighboring tiles share a cache
+    int tileCount = tileRows * tileCols;
+    int threads = threadCount();
+    for (int id = 0; id < threads; id++) {
+        int first = static_cast<int>(static_cast<long long>(tileCount) * id / threads);
+        int last = static_cast<int>(static_cast<long long>(tileCount) * (id + 1) / threads);
+        for (int tile = first; tile < last; tile++) {
+            queues[id]->tiles.push_back(tile);
+        }
+    }
+    changed = false;
+    long long living = outline.population();
+
+    {
+        lock_guard<mutex> guard(poolLock);
+        epoch++;
+        running = threads - 1;
+    }
+    startSignal.notify_all();
+    runTiles(0);
+    {
+        unique_lock<mutex> guard(poolLock);
+        while (running > 0) {
+            doneSignal.wait(guard);
+        }
+    }
+
+    long long born = 0;
+    for (int id = 0; id < threads; id++) {
+        WorkQueue* queue = queues[id];
+        outline.merge(queue->changes);
+        born += queue->born;
+        queue->born = 0;
+        for (int age = 0; age <= kMaxAge; age++) {
+            counts.ages[age] += queue->ageCounts[age];
+            queue->ageCounts[age] = 0;
+        }
+    }
+    ages.swap(next);
+    counts.births = born;
+    counts.deaths = born - (outline.population() - living);
+    return changed;
+}
+
+void ParallelLifeEngine::stats(LifeStats& stats) const {
+    if (!countingAges) {
+        SimdLifeEngine::countAges(ages, rows, cols, counts.ages);
+        countingAges = true;
+    }
+    stats = counts;
+    stats.population = outline.population();
+}
+
+int ParallelLifeEngine::ageAt(int row, int col) const {
+    return ages[indexOf(row, col)];
+}
+
+bool ParallelLifeEngine::setRule(const LifeRule& newRule) {
+    rule = newRule;
+    kernel = SimdLifeEngine::selectKernel(kernelType, rule);
+    return true;
+}
+
+bool ParallelLifeEngine::setWrapping(bool wrap) {
+    wrapping = wrap;
+    if (!wrap) {
+        SimdLifeEngine::fillBorder(ages, rows, cols, false);
+        SimdLifeEngine::fillBorder(next, rows, cols, false);
+    }
+    return true;
+}
+
+void ParallelLifeEngine::setThreadCount(int threadCount) {
+    stopWorkers();
+    startWorkers(threadCount);
+}
+
+void ParallelLifeEngine::startWorkers(int threadCount) {
+    if (threadCount <= 0) {
+        threadCount = max(1, static_cast<int>(thread::hardware_concurrency()));
+    }
+    quitting = false;
+    for (int id = 0; id < threadCount; id++) {
+        queues.push_back(new WorkQueue);
+    }
+    resetChanges();
+    for (int id = 1; id < threadCount; id++) {
+        workers.push_back(thread(&ParallelLifeEngine::workerLoop, this, id, epoch));
+    }
+}
+
+void ParallelLifeEngine::stopWorkers() {
+    {
+        lock_guard<mutex> guard(poolLock);
+        quitting = true;
+    }
+    startSignal.notify_all();
+    for (size_t i = 0; i < workers.size(); i++) {
+        workers[i].join();
+    }
+    workers.clear();
+    for (size_t i = 0; i < queues.size(); i++) {
+        delete queues[i];
+    }
+    queues.clear();
+}
+
+/**
+ * Body of each pool thread: sleeps until step bumps the epoch, drains
+ * tiles until none are left anywhere, then reports back.
+ */
+void ParallelLifeEngine::workerLoop(int id, long long startEpoch) {
+    long long seen = startEpoch;
+    while (true) {
+        {
+            unique_lock<mutex> guard(poolLock);
+            while (!quitting && epoch == seen) {
+                startSignal.wait(guard);
+            }
+            if (quitting) {
+                return;
+            }
+            seen = epoch;
+        }
+        runTiles(id);
+        {
+            lock_guard<mutex> guard(poolLock);
+            running--;
+        }
+        doneSignal.notify_one();
+    }
+}
+
+void ParallelLifeEngine::runTiles(int id) {
+    bool anyChanged = false;
+    int tile;
+    while (takeTile(id, tile)) {
+        if (stepTile(id, tile)) {
+            anyChanged = true;
+        }
+    }
+    if (anyChanged) {
+        changed = true;
+    }
+}
+
+/**
+ * Takes the next tile from the front of this worker's own queue, or steals
+ * one from the back of another queue.  Returns false once every queue is
+ * empty; no tiles are added during a step, so the worker can then stop.
+ */
+bool ParallelLifeEngine::takeTile(int id, int& tile) {
+    int threads = threadCount();
+    for (int offset = 0; offset < threads; offset++) {
+        WorkQueue* queue = queues[(id + offset) % threads];
+        lock_guard<mutex> guard(queue->lock);
+        if (!queue->tiles.empty()) {
+            if (offset == 0) {
+                tile = queue->tiles.front();
+                queue->tiles.pop_front();
+            } else {
+                tile = queue->tiles.back();
+                queue->tiles.pop_back();
+            }
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * Steps one tile on behalf of worker id, recording its births and deaths,
+ * and its age changes if the ages are being counted, in that worker's
+ * queue.
+ */
+bool ParallelLifeEngine::stepTile(int id, int tile) {
+    WorkQueue* queue = queues[id];
+    int top = (tile / tileCols) * kTileHeight;
+    int left = (tile % tileCols) * kTileWidth;
+    int bottom = min(top + kTileHeight, rows);
+    int width = min(left + kTileWidth, cols) - left;
+    bool tileChanged = false;
+    long long* ageCounts = countingAges ? queue->ageCounts : nullptr;
+    for (int r = top; r < bottom; r++) {
+        const uint8_t* mid = &ages[indexOf(r, left)];
+        uint8_t* out = &next[indexOf(r, left)];
+        if (kernel(mid - rowStride, mid, mid + rowStride, out, 0, width, rule, queue->flips.data(), ageCounts)) {
+            queue->born += queue->changes.update(r, left, queue->flips.data(), width, out);
+            fill(queue->flips.begin(), queue->flips.end(), 0);
+            tileChanged = true;
+        }
+    }
+    return tileChanged;
+}
+
+/**
+ * Sizes every worker's change tracker and scratch row for the current board
+ * and zeroes its counts.
+ */
+void ParallelLifeEngine::resetChanges() {
+    for (size_t i = 0; i < queues.size(); i++) {
+        queues[i]->changes.reset(rows, cols);
+        queues[i]->born = 0;
+        for (int age = 0; age <= kMaxAge; age++) {
+            queues[i]->ageCounts[age] = 0;
+        }
+        queues[i]->flips.assign(kTileWidth / 64, 0);
+    }
+}
+
+size_t ParallelLifeEngine::indexOf(int row, int col) const {
+    return static_cast<size_t>(row + 1) * rowStride + (col + 1);
+}
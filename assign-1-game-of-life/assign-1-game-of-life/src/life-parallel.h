@@ -0,0 +1,118 @@
+/**
+ * File: life-parallel.h
+ * ---------------------
+ * Defines a Life engine that steps the board on several threads at once.
+ * The board is cut into cache-sized tiles, each worker starts with an
+ * even share of them, and a worker that runs out steals tiles from the
+ * back of another worker's queue, so uneven activity still keeps every
+ * core busy.  Tiles use the same byte layout and row kernels as
+ * SimdLifeEngine.
+ */
+
+#pragma once
+#include <atomic>              // for std::atomic
+#include <condition_variable>  // for std::condition_variable
+#include <cstdint>             // for uint8_t, uint64_t
+#include <deque>               // for std::deque
+#include <mutex>               // for std::mutex
+#include <string>              // for std::string
+#include <thread>              // for std::thread
+#include <vector>              // for std::vector
+#include "grid.h"              // for Grid
+
+#include "life-engine.h"
+#include "life-shape.h"        // for ShapeTracker
+#include "life-simd.h"         // for SimdLifeEngine::RowKernel
+
+class ParallelLifeEngine : public LifeEngine {
+public:
+/**
+ * Constructs an empty engine that runs on the given number of threads.
+ * Passing 0 uses one thread per hardware core.
+ */
+    explicit ParallelLifeEngine(int threadCount = 0);
+
+/**
+ * Stops and joins the worker threads.
+ */
+    ~ParallelLifeEngine();
+
+    std::string name() const;
+    void load(const Grid<int>& board);
+    bool step();
+    int numRows() const { return rows; }
+    int numCols() const { return cols; }
+    int ageAt(int row, int col) const;
+    long long population() const { return outline.population(); }
+
+/**
+ * Each worker records the births and deaths in its tiles on its own, and
+ * step merges them once every tile is done.  Age changes are recorded the
+ * same way once the first call after a load has counted the ages.
+ */
+    void stats(LifeStats& stats) const;
+    void shape(LifeShape& shape) const { outline.fill(shape); }
+    bool setWrapping(bool wrap);
+    bool setRule(const LifeRule& newRule);
+
+/**
+ * Changes the number of threads used by later steps.  Passing 0 uses one
+ * thread per hardware core.
+ */
+    void setThreadCount(int threadCount);
+
+/**
+ * Returns the number of threads that step uses, including the caller's.
+ */
+    int threadCount() const { return static_cast<int>(queues.size()); }
+
+private:
+    struct WorkQueue {
+        std::mutex lock;
+        std::deque<int> tiles;
+        ShapeTracker changes;               // births and deaths in the tiles this queue's worker stepped
+        long long born;                     // how many of those were births
+        long long ageCounts[kMaxAge + 1];   // the change they made to each age count
+        std::vector<std::uint64_t> flips;   // that worker's scratch for one row of a tile
+    };
+
+    int rows;
+    int cols;
+    int rowStride;                    // cols plus a zero column on either side
+    int tileRows;
+    int tileCols;
+    std::vector<std::uint8_t> ages;   // (rows + 2) x rowStride, zero border all around
+    std::vector<std::uint8_t> next;   // scratch plane swapped with ages each step
+    ShapeTracker outline;             // updated by each step
+    mutable LifeStats counts;         // births, deaths and, once countingAges is set, ages
+    mutable bool countingAges;        // set by the first call to stats after a load
+    SimdLifeEngine::RowKernel kernel;
+    std::string kernelType;
+    bool wrapping;
+    LifeRule rule;
+
+    std::vector<WorkQueue*> queues;   // one per thread; queue 0 belongs to the caller of step
+    std::vector<std::thread> workers;
+    std::mutex poolLock;
+    std::condition_variable startSignal;
+    std::condition_variable doneSignal;
+    long long epoch;                  // bumped once per step to release the workers
+    int running;                      // workers still busy with this step
+    bool quitting;
+    std::atomic<bool> changed;
+
+    static const int kTileHeight = 32;
+    static const int kTileWidth = 2048;
+
+    void startWorkers(int threadCount);
+    void stopWorkers();
+    void workerLoop(int id, long long startEpoch);
+    void runTiles(int id);
+    bool takeTile(int id, int& tile);
+    bool stepTile(int id, int tile);
+    void resetChanges();
+    std::size_t indexOf(int row, int col) const;
+
+    ParallelLifeEngine(const ParallelLifeEngine& original);
+    void operator=(const ParallelLifeEngine& rhs) const;
+};
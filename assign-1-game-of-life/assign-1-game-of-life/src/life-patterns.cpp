@@ -0,0 +1,480 @@
+/**
+ * File: life-patterns.cpp
+ * -----------------------
+ * Implements the colony builders shared by the interactive and batch
+ * Life drivers.  The file parsers read through a PatternReader, which
+ * pulls the file in fixed-size blocks, and hand their cells to a
+ * CellBatch, which passes them on to the sink a batch at a time, so
+ * neither the file nor its cells are ever held in memory all at once.
+ */
+
+#include <algorithm>  // for max, min
+#include <cctype>     // for isalpha, isdigit, isspace, tolower
+#include <climits>    // for INT_MAX, INT_MIN
+#include <cstdio>     // for EOF
+#include <cstdlib>    // for strtoll
+#include <fstream>    // for ifstream
+#include <istream>    // for istream
+using namespace std;
+#include "random.h"  // for random number generation
+
+#include "life-constants.h"  // for kMaxAge
+#include "life-patterns.h"
+
+static const long long kNumberLimit = 1LL << 32;   // beyond any int, whatever its sign
+
+/**
+ * Reads a stream a character at a time through a buffer that is refilled
+ * in fixed-size blocks, so that a parser never holds more of the file.
+ */
+class PatternReader {
+public:
+    explicit PatternReader(istream& input) : input(input), buffer(kBlockSize), pos(0), size(0) {}
+
+    int peek() { return (pos < size || refill()) ? static_cast<unsigned char>(buffer[pos]) : EOF; }
+    int get() {
+        int c = peek();
+        pos += (c != EOF);
+        return c;
+    }
+    void skipLine();
+    void readLine(string& line);
+    bool readNumber(long long& value);
+
+private:
+    static const int kBlockSize = 1 << 16;
+
+    istream& input;
+    vector<char> buffer;
+    int pos;      // next character in buffer
+    int size;     // characters in buffer
+
+    bool refill();
+};
+
+/**
+ * Gathers the cells a parser decodes, gives each a random age and passes
+ * them to the sink a batch at a time.  The parser sets the size before
+ * adding any cells, and every cell must lie inside it.
+ */
+class CellBatch {
+public:
+    CellBatch(LifeCellSink& sink, LifeRandom* random);
+
+    void setSize(int rows, int cols);
+    void add(int row, int col);
+    void flush();
+    int numRows() const { return rows; }
+    int numCols() const { return cols; }
+    long long count() const { return added; }
+
+private:
+    static const size_t kBatchSize = 4096;
+
+    LifeCellSink& sink;
+    LifeRandom* random;       // nullptr to use the library's generator
+    vector<LifeCell> cells;
+    int rows;
+    int cols;
+    long long added;
+};
+
+/**
+ * A sink that appends the cells to a pattern's own list.
+ */
+class PatternSink : public LifeCellSink {
+public:
+    explicit PatternSink(LifePattern& pattern) : pattern(pattern) {}
+    void setSize(int, int) {}
+    void addCells(const vector<LifeCell>& cells) {
+        pattern.cells.insert(pattern.cells.end(), cells.begin(), cells.end());
+    }
+
+private:
+    LifePattern& pattern;
+};
+
+static bool parsePatternFile(const string& fileName, LifePattern& pattern, LifeCellSink& sink, LifeRandom* random);
+static bool skipComments(PatternReader& input, string* ruleText);
+static bool parsePlaintext(PatternReader& input, CellBatch& batch);
+static bool parseRle(PatternReader& input, LifePattern& pattern, CellBatch& batch);
+static bool parseLife106(PatternReader& input, CellBatch& batch);
+
+/**
+  * Function: fillCell
+  * ------------------
+  * Sets the value of grid cell
+  */
+int fillCell() {
+    if(randomInteger(0,1) == 0){
+        return 0;
+    }
+    else {
+        return randomInteger(1, kMaxAge);
+    }
+}
+
+void fillRandomGrid(Grid<int>& grid, int rows, int cols) {
+    grid.resize(rows, cols);
+    for(int r = 0; r < grid.numRows(); ++r) {
+        for(int c = 0; c < grid.numCols(); ++c) {
+            grid.set(r,c,fillCell());
+        }
+    }
+}
+
+void fillRandomGrid(Grid<int>& grid, int rows, int cols, LifeRandom& random) {
+    grid.resize(rows, cols);
+    for (int r = 0; r < rows; ++r) {
+        for (int c = 0; c < cols; ++c) {
+            grid.set(r, c, (random.nextInteger(0, 1) == 0) ? 0 : random.nextInteger(1, kMaxAge));
+        }
+    }
+}
+
+bool readPatternFile(const string& fileName, LifePattern& pattern) {
+    PatternSink sink(pattern);
+    return parsePatternFile(fileName, pattern, sink, nullptr);
+}
+
+bool readPatternFile(const string& fileName, LifePattern& pattern, LifeRandom& random) {
+    PatternSink sink(pattern);
+    return parsePatternFile(fileName, pattern, sink, &random);
+}
+
+bool readPatternFile(const string& fileName, LifePattern& pattern, LifeCellSink& sink) {
+    return parsePatternFile(fileName, pattern, sink, nullptr);
+}
+
+GridCellSink::GridCellSink(Grid<int>& grid) : grid(grid) {
+    // empty
+}
+
+void GridCellSink::setSize(int rows, int cols) {
+    grid.resize(rows, cols);
+}
+
+void GridCellSink::addCells(const vector<LifeCell>& cells) {
+    for (size_t i = 0; i < cells.size(); i++) {
+        grid.set(cells[i].row, cells[i].col, cells[i].age);
+    }
+}
+
+void PatternReader::skipLine() {
+    int c;
+    while ((c = get()) != EOF && c != '\n') {
+        // skip
+    }
+}
+
+/**
+ * Stores the rest of the current line in line, without its '\n'.
+ */
+void PatternReader::readLine(string& line) {
+    line.clear();
+    int c;
+    while ((c = get()) != EOF && c != '\n') {
+        line += static_cast<char>(c);
+    }
+}
+
+/**
+ * Reads a decimal number the way strtol does, skipping white space and
+ * taking an optional sign.  Numbers too large for an int stop at
+ * kNumberLimit, so callers can reject them with a range check without
+ * the arithmetic here overflowing.  Returns false if there are no digits.
+ */
+bool PatternReader::readNumber(long long& value) {
+    while (peek() != EOF && isspace(peek())) {
+        get();
+    }
+    bool negative = (peek() == '-');
+    if (peek() == '-' || peek() == '+') {
+        get();
+    }
+    if (!isdigit(peek())) {
+        return false;
+    }
+    value = 0;
+    while (isdigit(peek())) {
+        value = min(value * 10 + (get() - '0'), kNumberLimit);
+    }
+    value = negative ? -value : value;
+    return true;
+}
+
+bool PatternReader::refill() {
+    if (!input) {
+        return false;
+    }
+    input.read(&buffer[0], kBlockSize);
+    size = static_cast<int>(input.gcount());
+    pos = 0;
+    return size > 0;
+}
+
+CellBatch::CellBatch(LifeCellSink& sink, LifeRandom* random)
+        : sink(sink), random(random), rows(0), cols(0), added(0) {
+    cells.reserve(kBatchSize);
+}
+
+void CellBatch::setSize(int numRows, int numCols) {
+    rows = numRows;
+    cols = numCols;
+    sink.setSize(rows, cols);
+}
+
+/**
+ * Adds a live cell, whose age is drawn when its batch is passed on.
+ */
+void CellBatch::add(int row, int col) {
+    LifeCell cell = { row, col, 1 };
+    cells.push_back(cell);
+    if (cells.size() == kBatchSize) {
+        flush();
+    }
+}
+
+void CellBatch::flush() {
+    if (cells.empty()) {
+        return;
+    }
+    for (size_t i = 0; i < cells.size(); i++) {
+        cells[i].age = (random != nullptr) ? random->nextInteger(1, kMaxAge) : randomInteger(1, kMaxAge);
+    }
+    sink.addCells(cells);
+    added += static_cast<long long>(cells.size());
+    cells.clear();
+}
+
+/**
+ * Detects the file's format and decodes its live cells into the sink,
+ * drawing their ages from random, or from the library's generator if
+ * random is nullptr.
+ */
+static bool parsePatternFile(const string& fileName, LifePattern& pattern, LifeCellSink& sink, LifeRandom* random) {
+    ifstream stream(fileName.c_str(), ios::in | ios::binary);
+    if (stream.fail()) {
+        return false;
+    }
+    PatternReader input(stream);
+    CellBatch batch(sink, random);
+    pattern.rows = 0;
+    pattern.cols = 0;
+    pattern.population = 0;
+    pattern.cells.clear();
+    pattern.hasRule = false;
+    pattern.rule = kConwayRule;
+
+    bool parsed;
+    string ruleText;   // old RLE files give the rule in a "#r" comment instead of the header
+    string firstLine;
+    if (input.peek() == '#') {
+        input.readLine(firstLine);
+    }
+    if (firstLine.compare(0, 10, "#Life 1.06") == 0) {
+        parsed = parseLife106(input, batch);
+    } else {
+        if (firstLine.compare(0, 3, "#r ") == 0) {
+            ruleText = firstLine.substr(3);
+        }
+        if (skipComments(input, &ruleText) && input.peek() == 'x') {
+            if (!ruleText.empty()) {
+                pattern.hasRule = parseLifeRule(ruleText, pattern.rule);
+            }
+            parsed = parseRle(input, pattern, batch);
+        } else {
+            parsed = parsePlaintext(input, batch);
+        }
+    }
+    batch.flush();
+    pattern.rows = batch.numRows();
+    pattern.cols = batch.numCols();
+    pattern.population = batch.count();
+    return parsed && !stream.bad();
+}
+
+/**
+ * Skips blank lines and lines starting with '#', along with the white
+ * space before the first character of the first line that is neither.
+ * The text of any "#r" comment is stored in ruleText unless it is
+ * nullptr.  Returns false if the file ends first.
+ */
+static bool skipComments(PatternReader& input, string* ruleText) {
+    while (true) {
+        int c = input.peek();
+        while (c == ' ' || c == '\t' || c == '\r') {
+            input.get();
+            c = input.peek();
+        }
+        if (c == EOF) {
+            return false;
+        } else if (c == '\n') {
+            input.get();
+        } else if (c == '#') {
+            string comment;
+            input.readLine(comment);
+            if (ruleText != nullptr && comment.compare(0, 3, "#r ") == 0) {
+                *ruleText = comment.substr(3);
+            }
+        } else {
+            return true;
+        }
+    }
+}
+
+/**
+ * Parses the plaintext format used by the files in res/.  Characters past
+ * the declared number of columns are ignored, as are rows past the
+ * declared number of rows.
+ */
+static bool parsePlaintext(PatternReader& input, CellBatch& batch) {
+    int dimensions[2];
+    for (int i = 0; i < 2; i++) {
+        long long value;
+        if (!skipComments(input, nullptr) || !input.readNumber(value) || value < 0 || value > INT_MAX) {
+            return false;
+        }
+        dimensions[i] = static_cast<int>(value);
+        input.skipLine();
+    }
+    int rows = dimensions[0];
+    int cols = dimensions[1];
+    batch.setSize(rows, cols);
+
+    int row = 0;
+    while (row < rows && skipComments(input, nullptr)) {
+        int c;
+        for (int col = 0; (c = input.peek()) != EOF && c != '\n' && c != '\r'; col++) {
+            input.get();
+            if (c != '-' && col < cols) {
+                batch.add(row, col);
+            }
+        }
+        input.skipLine();
+        row++;
+    }
+    return true;
+}
+
+/**
+ * Parses an RLE header line and body.  Runs of 'b' or '.' are dead
+ * cells, runs of 'o' or any other letter are live ones, '$' ends a row
+ * and '!' ends the pattern.  Returns false if the header's size doesn't
+ * fit in an int or a run goes past it.
+ */
+static bool parseRle(PatternReader& input, LifePattern& pattern, CellBatch& batch) {
+    string line;
+    input.readLine(line);
+    long long size[2] = { -1, -1 };
+    size_t start = 0;
+    while (start < line.length()) {
+        size_t comma = line.find(',', start);
+        if (comma == string::npos) {
+            comma = line.length();
+        }
+        string field = line.substr(start, comma - start);
+        size_t equals = field.find('=');
+        if (equals != string::npos) {
+            string key;
+            for (size_t i = 0; i < equals; i++) {
+                if (!isspace(static_cast<unsigned char>(field[i]))) {
+                    key += static_cast<char>(tolower(static_cast<unsigned char>(field[i])));
+                }
+            }
+            string value = field.substr(equals + 1);
+            if (key == "x" || key == "y") {
+                size[key == "y"] = strtoll(value.c_str(), nullptr, 10);
+            } else if (key == "rule") {
+                pattern.hasRule = parseLifeRule(value, pattern.rule);
+            }
+        }
+        start = comma + 1;
+    }
+    if (size[0] < 0 || size[1] < 0 || size[0] > INT_MAX || size[1] > INT_MAX) {
+        return false;
+    }
+    int cols = static_cast<int>(size[0]);
+    int rows = static_cast<int>(size[1]);
+    batch.setSize(rows, cols);
+
+    int row = 0;
+    int col = 0;
+    int c;
+    while ((c = input.peek()) != EOF && c != '!') {
+        long long count = 1;
+        if (c >= '0' && c <= '9') {
+            count = 0;
+            while ((c = input.peek()) >= '0' && c <= '9') {
+                count = min(count * 10 + (input.get() - '0'), kNumberLimit);
+            }
+            if (c == EOF) {
+                break;
+            }
+        }
+        char tag = static_cast<char>(input.get());
+        if (tag == '$') {
+            if (row + count > rows) {
+                return false;
+            }
+            row += static_cast<int>(count);
+            col = 0;
+        } else if (tag == 'b' || tag == '.' || isalpha(static_cast<unsigned char>(tag))) {
+            if (col + count > cols || (row >= rows && count > 0)) {
+                return false;
+            }
+            bool alive = (tag != 'b' && tag != '.');
+            for (int i = 0; alive && i < count; i++) {
+                batch.add(row, col + i);
+            }
+            col += static_cast<int>(count);
+        } else if (tag == '#') {
+            input.skipLine();   // a comment after the header
+        }
+    }
+    return true;
+}
+
+/**
+ * Parses Life 1.06 coordinates, which are "x y" pairs of any sign, and
+ * shifts them so that the bounding box starts at (0, 0).  The shift is
+ * only known at the end, so these cells are gathered before any of them
+ * is passed on.  Returns false if a coordinate or the box's extent does
+ * not fit in an int.
+ */
+static bool parseLife106(PatternReader& input, CellBatch& batch) {
+    vector<LifeCell> cells;
+    int top = INT_MAX;
+    int left = INT_MAX;
+    int bottom = INT_MIN;
+    int right = INT_MIN;
+    while (skipComments(input, nullptr)) {
+        long long x;
+        long long y;
+        if (!input.readNumber(x) || !input.readNumber(y)
+                || x < INT_MIN || x > INT_MAX || y < INT_MIN || y > INT_MAX) {
+            return false;
+        }
+        input.skipLine();
+        LifeCell cell = { static_cast<int>(y), static_cast<int>(x), 1 };
+        cells.push_back(cell);
+        top = min(top, cell.row);
+        left = min(left, cell.col);
+        bottom = max(bottom, cell.row);
+        right = max(right, cell.col);
+    }
+    if (cells.empty()) {
+        batch.setSize(0, 0);
+        return true;
+    }
+    long long rows = static_cast<long long>(bottom) - top + 1;
+    long long cols = static_cast<long long>(right) - left + 1;
+    if (rows > INT_MAX || cols > INT_MAX) {
+        return false;
+    }
+    batch.setSize(static_cast<int>(rows), static_cast<int>(cols));
+    for (size_t i = 0; i < cells.size(); i++) {
+        batch.add(cells[i].row - top, cells[i].col - left);
+    }
+    return true;
+}
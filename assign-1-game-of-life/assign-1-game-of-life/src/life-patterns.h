@@ -0,0 +1,114 @@
+/**
+ * File: life-patterns.h
+ * ---------------------
+ * Defines the routines that create starting colonies, either at random
+ * or from pattern files, so that every driver builds its boards the same
+ * way.  Three file formats are understood:
+ *
+ *   - plaintext: the number of rows, the number of columns, then one line
+ *     per row with '-' for dead cells and any other character for live
+ *     ones (the format of the files in res/)
+ *   - RLE: an "x = 3, y = 3, rule = B3/S23" header followed by run-length
+ *     encoded rows, as used by most pattern collections
+ *   - Life 1.06: a "#Life 1.06" line followed by one "x y" pair per live cell
+ *
+ * In every format, lines starting with '#' before the cells are comments.
+ */
+
+#pragma once
+#include <string>    // for std::string
+#include <vector>    // for std::vector
+#include "grid.h"    // for Grid
+
+#include "life-engine.h"     // for LifeCell
+#include "life-random.h"     // for LifeRandom
+#include "life-rules.h"      // for LifeRule
+
+/**
+ * A colony as read from a file: the size of its bounding box and the
+ * live cells in it.  The cells are left empty when they are read into a
+ * LifeCellSink instead.
+ */
+struct LifePattern {
+    int rows;
+    int cols;
+    long long population;
+    std::vector<LifeCell> cells;
+    bool hasRule;                  // whether the file named a rule
+    LifeRule rule;
+};
+
+/**
+ * Class: LifeCellSink
+ * -------------------
+ * Receives the live cells of a pattern file as they are decoded, a batch
+ * at a time, so that a large pattern never has to be held as one list.
+ * The size is set once, before the first batch, and every cell lies
+ * inside it.
+ */
+class LifeCellSink {
+public:
+    virtual ~LifeCellSink() {}
+    virtual void setSize(int rows, int cols) = 0;
+    virtual void addCells(const std::vector<LifeCell>& cells) = 0;
+};
+
+/**
+ * Class: GridCellSink
+ * -------------------
+ * A sink that writes the cells straight into a grid, resizing it to the
+ * pattern's bounding box.
+ */
+class GridCellSink : public LifeCellSink {
+public:
+    explicit GridCellSink(Grid<int>& grid);
+    void setSize(int rows, int cols);
+    void addCells(const std::vector<LifeCell>& cells);
+
+private:
+    Grid<int>& grid;
+
+    GridCellSink(const GridCellSink&);
+    void operator=(const GridCellSink&) const;
+};
+
+/**
+ * Returns the starting value of a random cell: dead half of the time,
+ * and otherwise alive with a random age between 1 and kMaxAge.
+ */
+int fillCell();
+
+/**
+ * Resizes grid to the given dimensions and fills it using fillCell.
+ */
+void fillRandomGrid(Grid<int>& grid, int rows, int cols);
+
+/**
+ * Resizes grid and fills it as fillRandomGrid does, but draws from the
+ * given generator instead of the library's shared one, so that several
+ * threads can build boards at once.
+ */
+void fillRandomGrid(Grid<int>& grid, int rows, int cols, LifeRandom& random);
+
+/**
+ * Reads a pattern file in any of the formats above, which is recognized
+ * from its contents.  The file is read through a fixed-size buffer and
+ * its cells are decoded as the buffer fills, so even multi-megabyte files
+ * load quickly.  Live cells get a random age.  Returns false if the file
+ * could not be opened or is not a pattern.
+ */
+bool readPatternFile(const std::string& fileName, LifePattern& pattern);
+
+/**
+ * Reads a pattern file as above, but draws the ages from the given
+ * generator instead of the library's shared one, so that several threads
+ * can read files at once.
+ */
+bool readPatternFile(const std::string& fileName, LifePattern& pattern, LifeRandom& random);
+
+/**
+ * Reads a pattern file as above, but passes its cells to sink instead of
+ * storing them in the pattern, which only records the size, population
+ * and rule.
+ */
+bool readPatternFile(const std::string& fileName, LifePattern& pattern, LifeCellSink& sink);
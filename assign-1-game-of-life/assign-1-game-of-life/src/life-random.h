@@ -0,0 +1,55 @@
+/**
+ * File: life-random.h
+ * -------------------
+ * Defines a small, fast random number generator for code that needs many
+ * independent streams, such as one per worker thread.  The library's
+ * randomInteger shares one global generator, which threads cannot use
+ * at the same time and which cannot be split into reproducible streams.
+ */
+
+#pragma once
+#include <cstdint>   // for uint64_t
+
+class LifeRandom {
+public:
+/**
+ * Starts the stream numbered stream of the generator seeded with seed.
+ * The same seed and stream always produce the same numbers, and
+ * different streams are statistically independent.
+ */
+    explicit LifeRandom(std::uint64_t seed = 0, std::uint64_t stream = 0) { reseed(seed, stream); }
+
+/**
+ * Restarts the generator at the given seed and stream.
+ */
+    void reseed(std::uint64_t seed, std::uint64_t stream) {
+        state = mix(seed ^ mix(stream + 0x6a09e667f3bcc909ULL));
+    }
+
+/**
+ * Returns the next 64 random bits (SplitMix64).
+ */
+    std::uint64_t next() {
+        state += 0x9e3779b97f4a7c15ULL;
+        return mix(state);
+    }
+
+/**
+ * Returns a random integer between low and high, inclusive.  The range is
+ * mapped with a multiply rather than a division, which is slightly
+ * uneven for huge ranges but far faster.
+ */
+    int nextInteger(int low, int high) {
+        std::uint64_t range = static_cast<std::uint64_t>(static_cast<std::int64_t>(high) - low) + 1;
+        return low + static_cast<int>(((next() >> 32) * range) >> 32);
+    }
+
+private:
+    std::uint64_t state;
+
+    static std::uint64_t mix(std::uint64_t x) {
+        x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+        return x ^ (x >> 31);
+    }
+};
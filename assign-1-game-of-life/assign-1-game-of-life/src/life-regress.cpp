@@ -0,0 +1,317 @@
+/**
+ * File: life-regress.cpp
+ * ----------------------
+ * Implements the regression mode.  Each (pattern, engine) pair is one
+ * job, and workers take jobs from a shared counter so that a slow engine
+ * does not hold up the rest.  Every job reads its own copy of the pattern
+ * and builds its own engine, so nothing but the counter is shared.  The
+ * results are printed in job order once every job is done.
+ */
+
+#include <algorithm>  // for max
+#include <atomic>     // for atomic
+#include <chrono>     // for steady_clock
+#include <fstream>    // for ifstream, ofstream
+#include <iomanip>    // for setprecision, setw
+#include <iostream>   // for cout
+#include <sstream>    // for istringstream, ostringstream
+#include <thread>     // for thread
+#include <vector>     // for vector
+using namespace std;
+#include "console.h"  // for setConsoleEcho
+#include "filelib.h"  // for listDirectory
+#include "strlib.h"   // for stringIsInteger, stringToInteger, stringIsLong, stringToLong, stringSplit, trim
+
+#include "life-regress.h"
+#include "life-engine.h"     // for createLifeEngine, lifeEngineNames
+#include "life-patterns.h"   // for readPatternFile
+#include "life-random.h"     // for LifeRandom
+
+/**
+ * The engines whose results are written to the golden file, one on a
+ * bounded board and one on an unbounded one.
+ */
+static const char* const kReferenceEngines[2] = { "grid", "chunked" };
+
+/**
+ * The expected state of one pattern.  Index 0 is for bounded engines and
+ * index 1 for unbounded ones.
+ */
+struct GoldenPattern {
+    string name;
+    long long generations;
+    long long population[2];
+    uint64_t hash[2];
+};
+
+/**
+ * One pattern run on one engine, and what came of it.
+ */
+struct RegressionJob {
+    size_t pattern;                // index into the golden patterns
+    string engineName;
+    bool read;                     // false if the pattern file couldn't be read
+    bool supported;                // false if the engine can't run the pattern's rule
+    int bounded;                   // 1 if the engine is bounded, 0 if not
+    long long population;
+    uint64_t hash;
+    long long cells;               // size of the board
+    long long generations;         // generations actually simulated
+    double seconds;
+};
+
+static bool readGoldenFile(const string& fileName, vector<GoldenPattern>& patterns);
+static bool writeGoldenFile(const string& fileName, const vector<GoldenPattern>& patterns);
+static void runJobs(const string& directory, const vector<GoldenPattern>& patterns,
+                    atomic<size_t>& nextJob, vector<RegressionJob>& jobs);
+static void runJob(const string& directory, const GoldenPattern& golden, RegressionJob& job);
+static void printUsage();
+
+int runRegression(const Vector<string>& args) {
+    setConsoleEcho(true);
+
+    string directory = "files";
+    string goldenName = "golden.txt";
+    Vector<string> engineNames = lifeEngineNames();
+    int threads = 0;
+    bool update = false;
+    long long generations = 1000;
+    for (int i = 0; i < args.size(); i++) {
+        bool hasValue = i + 1 < args.size();
+        if (args[i] == "--regress") {
+            continue;
+        } else if (args[i] == "--dir" && hasValue) {
+            directory = args[++i];
+        } else if (args[i] == "--golden" && hasValue) {
+            goldenName = args[++i];
+        } else if (args[i] == "--engine" && hasValue) {
+            engineNames = stringSplit(args[++i], ",");
+        } else if (args[i] == "--threads" && hasValue && stringIsInteger(args[i + 1])) {
+            threads = stringToInteger(args[++i]);
+        } else if (args[i] == "--update") {
+            update = true;
+        } else if (args[i] == "--generations" && hasValue && stringIsLong(args[i + 1])) {
+            generations = stringToLong(args[++i]);
+        } else {
+            printUsage();
+            return 1;
+        }
+    }
+    if (generations < 0) {
+        printUsage();
+        return 1;
+    }
+    if (threads <= 0) {
+        threads = max(1, static_cast<int>(thread::hardware_concurrency()));
+    }
+    Vector<string> knownEngines = lifeEngineNames();
+    for (int i = 0; i < engineNames.size(); i++) {
+        if (!knownEngines.contains(engineNames[i])) {
+            cout << "Error. There is no engine called " << engineNames[i] << "." << endl;
+            return 1;
+        }
+    }
+
+    vector<GoldenPattern> patterns;
+    if (update) {
+        // the reference engines fill in the golden values below
+        Vector<string> names = listDirectory(directory);
+        for (int i = 0; i < names.size(); i++) {
+            GoldenPattern golden = { names[i], generations, { 0, 0 }, { 0, 0 } };
+            patterns.push_back(golden);
+        }
+        engineNames.clear();
+        engineNames.add(kReferenceEngines[0]);
+        engineNames.add(kReferenceEngines[1]);
+    } else if (!readGoldenFile(goldenName, patterns)) {
+        cout << "Error. Couldn't read golden file " << goldenName << "." << endl;
+        return 1;
+    }
+
+    vector<RegressionJob> jobs;
+    for (size_t p = 0; p < patterns.size(); p++) {
+        for (int e = 0; e < engineNames.size(); e++) {
+            RegressionJob job = { p, engineNames[e], false, false, 1, 0, 0, 0, 0, 0 };
+            jobs.push_back(job);
+        }
+    }
+    atomic<size_t> nextJob(0);
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    vector<thread> workers;
+    for (int id = 1; id < threads; id++) {
+        workers.push_back(thread(runJobs, cref(directory), cref(patterns), ref(nextJob), ref(jobs)));
+    }
+    runJobs(directory, patterns, nextJob, jobs);
+    for (size_t i = 0; i < workers.size(); i++) {
+        workers[i].join();
+    }
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+    int passed = 0;
+    int failed = 0;
+    int skipped = 0;
+    // format into a local stream so that the console's formatting is left alone
+    ostringstream report;
+    report << fixed << setprecision(3);
+    for (size_t i = 0; i < jobs.size(); i++) {
+        RegressionJob& job = jobs[i];
+        GoldenPattern& golden = patterns[job.pattern];
+        string verdict;
+        if (!job.read) {
+            verdict = update ? "SKIP" : "FAIL";
+        } else if (!job.supported) {
+            verdict = "SKIP";
+        } else if (update) {
+            golden.population[1 - job.bounded] = job.population;
+            golden.hash[1 - job.bounded] = job.hash;
+            verdict = "DONE";
+        } else if (job.population == golden.population[1 - job.bounded]
+                   && job.hash == golden.hash[1 - job.bounded]) {
+            verdict = "OK";
+        } else {
+            verdict = "FAIL";
+        }
+        if (verdict == "OK" || verdict == "DONE") {
+            passed++;
+        } else if (verdict == "FAIL") {
+            failed++;
+        } else {
+            skipped++;
+        }
+
+        report << setw(5) << left << verdict << setw(20) << golden.name << setw(10) << job.engineName << right;
+        if (!job.read) {
+            report << "  couldn't read pattern" << endl;
+            continue;
+        } else if (!job.supported) {
+            report << "  can't simulate the pattern's rule" << endl;
+            continue;
+        }
+        double perSecond = (job.seconds > 0) ? job.generations / job.seconds : 0;
+        report << setw(10) << job.seconds << " s" << setw(14) << perSecond << " gens/s"
+               << setw(16) << perSecond * job.cells << " cells/s";
+        if (verdict == "FAIL") {
+            report << "  population " << job.population << " (expected " << golden.population[1 - job.bounded]
+                   << "), hash " << hex << job.hash << " (expected " << golden.hash[1 - job.bounded] << ")" << dec;
+        }
+        report << endl;
+    }
+
+    if (update) {
+        // keep only the files that read as patterns
+        vector<GoldenPattern> readable;
+        for (size_t i = 0; i < jobs.size(); i++) {
+            if (jobs[i].read && jobs[i].engineName == kReferenceEngines[0]) {
+                readable.push_back(patterns[jobs[i].pattern]);
+            }
+        }
+        if (!writeGoldenFile(goldenName, readable)) {
+            cout << report.str() << "Error. Couldn't write golden file " << goldenName << "." << endl;
+            return 1;
+        }
+        report << "golden:          " << readable.size() << " patterns written to " << goldenName << endl;
+    }
+    report << "run time:        " << seconds << " s on " << threads << " threads" << endl;
+    report << "passed:          " << passed << " of " << jobs.size();
+    if (skipped > 0) {
+        report << " (" << skipped << " skipped)";
+    }
+    report << endl;
+    cout << report.str();
+    return (failed > 0) ? 1 : 0;
+}
+
+/**
+ * Reads the golden file into patterns, skipping comments and blank
+ * lines.  Returns false if the file can't be opened or a line is garbled.
+ */
+static bool readGoldenFile(const string& fileName, vector<GoldenPattern>& patterns) {
+    ifstream input(fileName.c_str());
+    if (input.fail()) {
+        return false;
+    }
+    string line;
+    while (getline(input, line)) {
+        line = trim(line);
+        if (line.empty() || line[0] == '#') {
+            continue;
+        }
+        istringstream fields(line);
+        GoldenPattern golden;
+        fields >> golden.generations >> golden.population[0] >> hex >> golden.hash[0] >> dec
+               >> golden.population[1] >> hex >> golden.hash[1] >> dec;
+        getline(fields, golden.name);
+        golden.name = trim(golden.name);
+        if (fields.fail() || golden.name.empty()) {
+            return false;
+        }
+        patterns.push_back(golden);
+    }
+    return true;
+}
+
+static bool writeGoldenFile(const string& fileName, const vector<GoldenPattern>& patterns) {
+    ofstream output(fileName.c_str());
+    if (output.fail()) {
+        return false;
+    }
+    output << "# Golden values for life --regress, written by life --regress --update." << endl;
+    output << "# generations, bounded population and hash, unbounded population and hash, file" << endl;
+    for (size_t i = 0; i < patterns.size(); i++) {
+        const GoldenPattern& golden = patterns[i];
+        output << golden.generations << ' ' << golden.population[0] << ' ' << hex << golden.hash[0] << dec
+               << ' ' << golden.population[1] << ' ' << hex << golden.hash[1] << dec << ' ' << golden.name << endl;
+    }
+    output.close();
+    return !output.fail();
+}
+
+/**
+ * Body of each worker: runs jobs until the counter passes the last one.
+ */
+static void runJobs(const string& directory, const vector<GoldenPattern>& patterns,
+                    atomic<size_t>& nextJob, vector<RegressionJob>& jobs) {
+    size_t index;
+    while ((index = nextJob++) < jobs.size()) {
+        runJob(directory, patterns[jobs[index].pattern], jobs[index]);
+    }
+}
+
+/**
+ * Reads the job's pattern, runs it on the job's engine for the golden
+ * number of generations and records the population, hash and timing.
+ * Ages come from a generator seeded by the pattern, since the shared
+ * random number generator is not safe to use from several threads.
+ */
+static void runJob(const string& directory, const GoldenPattern& golden, RegressionJob& job) {
+    LifePattern pattern;
+    LifeRandom random(1, job.pattern);
+    job.read = readPatternFile(directory + "/" + golden.name, pattern, random);
+    if (!job.read) {
+        return;
+    }
+    LifeEngine* engine = createLifeEngine(job.engineName);
+    job.bounded = engine->isBounded() ? 1 : 0;
+    job.supported = engine->setRule(pattern.hasRule ? pattern.rule : kConwayRule);
+    if (job.supported) {
+        engine->loadCells(pattern.rows, pattern.cols, pattern.cells);
+        chrono::steady_clock::time_point start = chrono::steady_clock::now();
+        long long steps = golden.generations / engine->stepSize();
+        for (long long i = 0; i < steps; i++) {
+            engine->step();
+        }
+        job.seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        job.generations = steps * engine->stepSize();
+        job.cells = static_cast<long long>(pattern.rows) * pattern.cols;
+        job.population = engine->population();
+        int top;
+        int left;
+        job.hash = engine->patternHash(top, left);
+    }
+    delete engine;
+}
+
+static void printUsage() {
+    cout << "Usage: life --regress [--dir PATH] [--golden PATH] [--engine NAME[,NAME...]]" << endl;
+    cout << "            [--threads N] [--update [--generations N]]" << endl;
+}
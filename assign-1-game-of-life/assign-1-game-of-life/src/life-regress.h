@@ -0,0 +1,37 @@
+/**
+ * File: life-regress.h
+ * --------------------
+ * Defines the regression mode of the Game of Life.  It runs every pattern
+ * in the pattern library on every engine, in parallel, and checks the
+ * population and shape after a fixed number of generations against the
+ * golden values stored next to the library, so that an engine change that
+ * breaks a pattern is caught without opening a LifeDisplay.
+ */
+
+#pragma once
+#include <string>    // for std::string
+#include "vector.h"  // for Vector
+
+/**
+ * Runs the regression described by args and returns the exit status,
+ * which is 1 if any pattern fails.  Recognized arguments:
+ *
+ *   --regress                select this mode
+ *   --dir PATH               directory holding the patterns (default files)
+ *   --golden PATH            file holding the golden values (default golden.txt)
+ *   --engine NAME[,NAME...]  engines to check (default all of them)
+ *   --threads N              worker threads (default one per core)
+ *   --update                 rewrite the golden file from every pattern in the
+ *                            directory instead of checking it
+ *   --generations N          generations each pattern runs for with --update
+ *                            (default 1000)
+ *
+ * Each line of the golden file holds the number of generations, then the
+ * population and pattern hash on a bounded board, then the same on an
+ * unbounded one, then the name of the pattern file.  Lines starting with
+ * '#' are comments.  Bounded engines are checked against the first pair
+ * and the others against the second, since the two disagree once a
+ * pattern reaches the edge of the board.  Every (pattern, engine) run
+ * prints its result with its generations/sec and cells/sec.
+ */
+int runRegression(const Vector<std::string>& args);
@@ -0,0 +1,99 @@
+/**
+ * File: life-rules.cpp
+ * --------------------
+ * Implements parsing and printing of B/S rule strings.
+ */
+
+#include <cctype>     // for isspace, tolower
+using namespace std;
+
+#include "life-rules.h"
+
+static bool parseCounts(const string& digits, unsigned int& mask);
+
+bool operator ==(const LifeRule& rule1, const LifeRule& rule2) {
+    return rule1.birth == rule2.birth && rule1.survival == rule2.survival;
+}
+
+bool operator !=(const LifeRule& rule1, const LifeRule& rule2) {
+    return !(rule1 == rule2);
+}
+
+bool parseLifeRule(const string& text, LifeRule& rule) {
+    string lower;
+    for (size_t i = 0; i < text.length(); i++) {
+        if (!isspace(static_cast<unsigned char>(text[i]))) {
+            lower += static_cast<char>(tolower(static_cast<unsigned char>(text[i])));
+        }
+    }
+
+    if (lower == "life" || lower == "conway") {
+        lower = "b3/s23";
+    } else if (lower == "highlife") {
+        lower = "b36/s23";
+    } else if (lower == "seeds") {
+        lower = "b2/s";
+    } else if (lower == "dayandnight" || lower == "day&night") {
+        lower = "b3678/s34678";
+    }
+
+    size_t slash = lower.find('/');
+    if (slash == string::npos) {
+        return false;
+    }
+    string first = lower.substr(0, slash);
+    string second = lower.substr(slash + 1);
+    string birth;
+    string survival;
+    if (!first.empty() && first[0] == 'b' && !second.empty() && second[0] == 's') {
+        birth = first.substr(1);
+        survival = second.substr(1);
+    } else if (!first.empty() && first[0] == 's' && !second.empty() && second[0] == 'b') {
+        survival = first.substr(1);
+        birth = second.substr(1);
+    } else {
+        survival = first;
+        birth = second;
+    }
+
+    LifeRule parsed;
+    if (!parseCounts(birth, parsed.birth) || !parseCounts(survival, parsed.survival)) {
+        return false;
+    }
+    if (parsed.birth & 1) {
+        return false;
+    }
+    rule = parsed;
+    return true;
+}
+
+string lifeRuleString(const LifeRule& rule) {
+    string text = "B";
+    for (int n = 0; n <= 8; n++) {
+        if ((rule.birth >> n) & 1) {
+            text += static_cast<char>('0' + n);
+        }
+    }
+    text += "/S";
+    for (int n = 0; n <= 8; n++) {
+        if ((rule.survival >> n) & 1) {
+            text += static_cast<char>('0' + n);
+        }
+    }
+    return text;
+}
+
+/**
+ * Sets mask to the neighbor counts listed in digits, each between 0 and 8.
+ * Returns false if anything else appears.
+ */
+static bool parseCounts(const string& digits, unsigned int& mask) {
+    mask = 0;
+    for (size_t i = 0; i < digits.length(); i++) {
+        if (digits[i] < '0' || digits[i] > '8') {
+            return false;
+        }
+        mask |= 1u << (digits[i] - '0');
+    }
+    return true;
+}
@@ -0,0 +1,77 @@
+/**
+ * File: life-rules.h
+ * ------------------
+ * Defines the birth/survival rules that the engines can simulate, written
+ * in the usual B/S notation: "B3/S23" is Conway's Life, where a dead cell
+ * with 3 neighbors is born and a live cell with 2 or 3 neighbors survives.
+ *
+ * Ages follow the same pattern as Conway's rules: a surviving cell whose
+ * neighbor count would also give birth grows one generation older, any
+ * other survivor keeps its age, and a newborn cell has age 1.
+ */
+
+#pragma once
+#include <string>    // for std::string
+
+#include "life-constants.h"  // for kMaxAge
+
+/**
+ * Bit n of birth is set if a dead cell with n live neighbors comes to
+ * life, and bit n of survival if a live cell with n neighbors stays alive.
+ */
+struct LifeRule {
+    unsigned int birth;
+    unsigned int survival;
+};
+
+const unsigned int kConwayBirth = 1 << 3;
+const unsigned int kConwaySurvival = (1 << 2) | (1 << 3);
+const LifeRule kConwayRule = { kConwayBirth, kConwaySurvival };
+
+/**
+ * Stands for a rule that is only known at runtime when used as a template
+ * argument of a rule kernel; such kernels read the rule from a LifeRule.
+ */
+const unsigned int kAnyRule = ~0u;
+
+/**
+ * Lists the rules that the engines compile dedicated kernels for, as
+ * X(birth, survival) entries, so that these rules step as fast as Conway's
+ * does.  Any other rule runs on a general kernel instantiated with kAnyRule.
+ */
+#define LIFE_SPECIALIZED_RULES(X) \
+    X(0x008, 0x00c)   /* Life, B3/S23 */ \
+    X(0x048, 0x00c)   /* HighLife, B36/S23 */ \
+    X(0x004, 0x000)   /* Seeds, B2/S */ \
+    X(0x1c8, 0x1d8)   /* Day & Night, B3678/S34678 */
+
+bool operator ==(const LifeRule& rule1, const LifeRule& rule2);
+bool operator !=(const LifeRule& rule1, const LifeRule& rule2);
+
+/**
+ * Parses a rule such as "B36/S23" (case does not matter, and the older
+ * "23/36" survival/birth form is accepted too) or one of the names
+ * "Life", "HighLife", "Seeds" and "DayAndNight".  Returns false if the
+ * text is not a rule.  Rules where cells are born with 0 neighbors are
+ * rejected, since they would fill an unbounded universe in one step.
+ */
+bool parseLifeRule(const std::string& text, LifeRule& rule);
+
+/**
+ * Returns the rule in B/S notation, e.g. "B3/S23".
+ */
+std::string lifeRuleString(const LifeRule& rule);
+
+/**
+ * Returns the age of a cell in the next generation, given its current
+ * age (0 if dead) and its number of live neighbors.
+ */
+inline int nextAge(const LifeRule& rule, int age, int neighbors) {
+    bool born = (rule.birth >> neighbors) & 1;
+    if (age == 0) {
+        return born ? 1 : 0;
+    } else if ((rule.survival >> neighbors) & 1) {
+        return (born && age < kMaxAge) ? age + 1 : age;
+    }
+    return 0;
+}
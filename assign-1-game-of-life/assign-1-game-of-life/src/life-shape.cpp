@@ -0,0 +1,214 @@
+/**
+ * File: life-shape.cpp
+ * --------------------
+ * Implements the pattern hash and the shape tracker.  Powers with negative
+ * exponents use the base's inverse modulo 2^64, found by Newton's method.
+ */
+
+#include <algorithm>  // for min, max
+using namespace std;
+
+#include "life-shape.h"
+#include "life-bitwise.h"   // for lowestBit, bitCount
+
+/**
+ * Returns the inverse of an odd number modulo 2^64.  Every odd number is
+ * its own inverse modulo 8, and each round doubles the bits that are right.
+ */
+static uint64_t hashInverse(uint64_t odd) {
+    uint64_t inverse = odd;
+    for (int round = 0; round < 5; round++) {
+        inverse *= 2 - odd * inverse;
+    }
+    return inverse;
+}
+
+uint64_t hashPower(uint64_t base, long long exponent) {
+    if (exponent < 0) {
+        base = hashInverse(base);
+        exponent = -exponent;
+    }
+    uint64_t power = 1;
+    for (; exponent > 0; exponent >>= 1) {
+        if (exponent & 1) {
+            power *= base;
+        }
+        base *= base;
+    }
+    return power;
+}
+
+uint64_t wordHash(uint64_t word, const uint64_t* colHashes) {
+    uint64_t hash = 0;
+    for (; word != 0; word &= word - 1) {
+        hash += colHashes[lowestBit(word)];
+    }
+    return hash;
+}
+
+void columnHashes(int count, vector<uint64_t>& colHashes) {
+    colHashes.resize(max(0, count));
+    uint64_t hash = 1;
+    for (int col = 0; col < count; col++) {
+        colHashes[col] = hash;
+        hash *= kColHashBase;
+    }
+}
+
+void scanShape(const LifeEngine& engine, LifeShape& shape) {
+    vector<uint64_t> colHashes;
+    columnHashes(engine.numCols(), colHashes);
+    shape.population = 0;
+    shape.top = engine.numRows();
+    shape.left = engine.numCols();
+    shape.bottom = 0;
+    shape.right = 0;
+    shape.hash = 0;
+    uint64_t rowHash = 1;
+    for (int i = 0; i < engine.numRows(); i++) {
+        for (int j = 0; j < engine.numCols(); j++) {
+            if (engine.ageAt(i, j) > 0) {
+                shape.population++;
+                shape.hash += rowHash * colHashes[j];
+                shape.top = min(shape.top, i);
+                shape.bottom = i + 1;
+                shape.left = min(shape.left, j);
+                shape.right = max(shape.right, j + 1);
+            }
+        }
+        rowHash *= kRowHashBase;
+    }
+    if (shape.population == 0) {
+        shape.top = 0;
+        shape.left = 0;
+    }
+}
+
+ShapeTracker::ShapeTracker()
+        : count(0), hash(0), changed(false), top(0), left(0), bottom(0), right(0) {
+    // empty
+}
+
+void ShapeTracker::reset(int rows, int cols) {
+    rowHashes.resize(max(0, rows));
+    uint64_t rowHash = 1;
+    for (int row = 0; row < rows; row++) {
+        rowHashes[row] = rowHash;
+        rowHash *= kRowHashBase;
+    }
+    columnHashes(cols, colHashes);
+    rowCounts.assign(rowHashes.size(), 0);
+    colCounts.assign(colHashes.size(), 0);
+    count = 0;
+    hash = 0;
+    changed = false;
+    top = static_cast<int>(rowCounts.size());
+    left = static_cast<int>(colCounts.size());
+    bottom = 0;
+    right = 0;
+}
+
+void ShapeTracker::update(int row, int firstCol, uint64_t born, uint64_t died) {
+    if ((born | died) == 0) {
+        return;
+    }
+    uint64_t sum = 0;
+    for (uint64_t word = born; word != 0; word &= word - 1) {
+        int col = firstCol + lowestBit(word);
+        sum += colHashes[col];
+        colCounts[col]++;
+        left = min(left, col);
+        right = max(right, col + 1);
+    }
+    for (uint64_t word = died; word != 0; word &= word - 1) {
+        int col = firstCol + lowestBit(word);
+        sum -= colHashes[col];
+        colCounts[col]--;
+    }
+    hash += rowHashes[row] * sum;
+    int delta = bitCount(born) - bitCount(died);
+    count += delta;
+    rowCounts[row] += delta;
+    if (born != 0) {
+        top = min(top, row);
+        bottom = max(bottom, row + 1);
+    }
+    changed = true;
+}
+
+int ShapeTracker::update(int row, int firstCol, const uint64_t* flips, int cells, const uint8_t* ages) {
+    int births = 0;
+    for (int w = 0; w < (cells + 63) / 64; w++) {
+        for (uint64_t word = flips[w]; word != 0; word &= word - 1) {
+            int i = 64 * w + lowestBit(word);
+            if (ages[i] > 0) {
+                add(row, firstCol + i);
+                births++;
+            } else {
+                remove(row, firstCol + i);
+            }
+        }
+    }
+    return births;
+}
+
+void ShapeTracker::merge(ShapeTracker& changes) {
+    if (!changes.changed) {
+        return;
+    }
+    hash += changes.hash;
+    count += changes.count;
+    for (size_t row = 0; row < rowCounts.size(); row++) {
+        rowCounts[row] += changes.rowCounts[row];
+    }
+    for (size_t col = 0; col < colCounts.size(); col++) {
+        colCounts[col] += changes.colCounts[col];
+    }
+    top = min(top, changes.top);
+    left = min(left, changes.left);
+    bottom = max(bottom, changes.bottom);
+    right = max(right, changes.right);
+    changed = true;
+
+    changes.rowCounts.assign(rowCounts.size(), 0);
+    changes.colCounts.assign(colCounts.size(), 0);
+    changes.count = 0;
+    changes.hash = 0;
+    changes.changed = false;
+    changes.top = static_cast<int>(rowCounts.size());
+    changes.left = static_cast<int>(colCounts.size());
+    changes.bottom = 0;
+    changes.right = 0;
+}
+
+void ShapeTracker::fill(LifeShape& shape) const {
+    while (top < bottom && rowCounts[top] == 0) {
+        top++;
+    }
+    while (bottom > top && rowCounts[bottom - 1] == 0) {
+        bottom--;
+    }
+    while (left < right && colCounts[left] == 0) {
+        left++;
+    }
+    while (right > left && colCounts[right - 1] == 0) {
+        right--;
+    }
+    shape.population = count;
+    shape.hash = hash;
+    if (count == 0) {
+        top = static_cast<int>(rowCounts.size());
+        left = static_cast<int>(colCounts.size());
+        bottom = 0;
+        right = 0;
+        shape.top = 0;
+        shape.left = 0;
+        shape.bottom = 0;
+        shape.right = 0;
+    } else {
+        shape.top = top;
+        shape.left = left;
+        shape.bottom = bottom;
+        shape.right = right;
+    }
+}
@@ -0,0 +1,158 @@
+/**
+ * File: life-shape.h
+ * ------------------
+ * Defines the hash that identifies a set of live cells and a tracker that
+ * keeps a bounded board's LifeShape up to date as cells are born and die.
+ * A cell at (row, col) hashes to R^row * C^col for two odd 64-bit bases,
+ * with all arithmetic modulo 2^64.  The hash of a pattern is the sum over
+ * its cells, so an engine can add and subtract cells as it steps, and
+ * moving a pattern multiplies its hash by a power of each base, so the
+ * hash seen from the bounding box's corner follows from the one seen from
+ * the origin without visiting the cells again.
+ */
+
+#pragma once
+#include <cstdint>   // for uint8_t, uint64_t
+#include <vector>    // for std::vector
+
+#include "life-engine.h"   // for LifeShape
+
+/**
+ * The bases of cellHash for rows and columns.  Both are odd, so every
+ * power of them has an inverse modulo 2^64.
+ */
+const std::uint64_t kRowHashBase = 0x9e3779b97f4a7c15ULL;
+const std::uint64_t kColHashBase = 0xbf58476d1ce4e5b9ULL;
+
+/**
+ * Returns base raised to exponent modulo 2^64.  The base must be odd; a
+ * negative exponent raises its inverse instead.
+ */
+std::uint64_t hashPower(std::uint64_t base, long long exponent);
+
+/**
+ * Returns the hash contribution of a live cell at the given row and column.
+ * A pattern's hash is the sum of the contributions of its cells, so it can
+ * be built in any order and updated one cell at a time.
+ */
+inline std::uint64_t cellHash(int row, int col) {
+    return hashPower(kRowHashBase, row) * hashPower(kColHashBase, col);
+}
+
+/**
+ * Returns the hash that a pattern with the given hash has once it is moved
+ * down by rows and right by cols, which may be negative.
+ */
+inline std::uint64_t moveHash(std::uint64_t hash, int rows, int cols) {
+    return hash * hashPower(kRowHashBase, rows) * hashPower(kColHashBase, cols);
+}
+
+/**
+ * Returns the sum of colHashes[b] over the set bits b of word, which is the
+ * hash of the word's cells in row 0 when colHashes[b] is the hash of the
+ * cell at column b.
+ */
+std::uint64_t wordHash(std::uint64_t word, const std::uint64_t* colHashes);
+
+/**
+ * Fills colHashes with the hashes of row 0's first count cells.
+ */
+void columnHashes(int count, std::vector<std::uint64_t>& colHashes);
+
+/**
+ * Fills shape by visiting every cell of the engine's board.
+ */
+void scanShape(const LifeEngine& engine, LifeShape& shape);
+
+/**
+ * Class: ShapeTracker
+ * -------------------
+ * Keeps the shape of a bounded board as its engine reports births and
+ * deaths.  The tracker counts the live cells in every row and column, so
+ * the bounding box can shrink as well as grow; edges that may have moved
+ * inward are only settled when the shape is read.
+ */
+class ShapeTracker {
+public:
+/**
+ * Constructs a tracker for an empty 0 x 0 board.
+ */
+    ShapeTracker();
+
+/**
+ * Starts over with an empty rows x cols board.
+ */
+    void reset(int rows, int cols);
+
+/**
+ * Records that the cell at (row, col) was born or died.
+ */
+    void add(int row, int col);
+    void remove(int row, int col);
+
+/**
+ * Records the births and deaths of a word of cells, where bit b stands for
+ * the cell at (row, firstCol + b).
+ */
+    void update(int row, int firstCol, std::uint64_t born, std::uint64_t died);
+
+/**
+ * Records the births and deaths among a run of cells in a row, as left in
+ * flips by the SimdLifeEngine row kernels.  Bit i % 64 of flips[i / 64]
+ * stands for the cell at column firstCol + i, for i below cells, and ages
+ * holds the run's new generation, which tells births from deaths.  Returns
+ * the number of births.
+ */
+    int update(int row, int firstCol, const std::uint64_t* flips, int cells, const std::uint8_t* ages);
+
+/**
+ * Adds the births and deaths recorded by changes, a tracker for a board of
+ * the same size, and resets changes to an empty board.  Threads that step
+ * parts of one board each record into their own tracker and are merged
+ * once they are done.
+ */
+    void merge(ShapeTracker& changes);
+
+/**
+ * Fills shape with the board's current shape.
+ */
+    void fill(LifeShape& shape) const;
+
+    long long population() const { return count; }
+
+private:
+    std::vector<std::uint64_t> rowHashes;   // hash of the cell at (row, 0)
+    std::vector<std::uint64_t> colHashes;   // hash of the cell at (0, col)
+    std::vector<int> rowCounts;             // live cells in each row
+    std::vector<int> colCounts;             // live cells in each column
+    long long count;
+    std::uint64_t hash;
+    bool changed;                           // anything recorded since the last reset
+
+    // every live cell lies inside these, and an empty tracker has top at rows,
+    // left at cols and bottom and right at 0; fill moves them in onto the live cells
+    mutable int top;
+    mutable int left;
+    mutable int bottom;
+    mutable int right;
+};
+
+inline void ShapeTracker::add(int row, int col) {
+    hash += rowHashes[row] * colHashes[col];
+    count++;
+    rowCounts[row]++;
+    colCounts[col]++;
+    top = (row < top) ? row : top;
+    bottom = (row >= bottom) ? row + 1 : bottom;
+    left = (col < left) ? col : left;
+    right = (col >= right) ? col + 1 : right;
+    changed = true;
+}
+
+inline void ShapeTracker::remove(int row, int col) {
+    hash -= rowHashes[row] * colHashes[col];
+    count--;
+    rowCounts[row]--;
+    colCounts[col]--;
+    changed = true;
+}
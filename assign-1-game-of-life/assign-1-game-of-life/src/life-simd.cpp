@@ -0,0 +1,390 @@
+/**
+ * File: life-simd.cpp
+ * -------------------
+ * Implements the byte-lane Life engine.  Each kernel sums the eight
+ * neighbors of a run of cells with unaligned loads at the eight neighbor
+ * offsets, clamping each loaded age to 1 so that the sum is a count.
+ * The vector kernels only handle whole vectors; the rest of the row is
+ * finished by the scalar kernel so nothing is ever written into the border.
+ * Each kernel also compares which lanes are alive before and after, which
+ * gives the births and deaths that keep the engine's outline up to date,
+ * and moves each lane whose age changed between the age counts when the
+ * engine is keeping them.
+ */
+
+#include <algorithm>  // for min, fill
+#include <cstring>    // for memcpy, memset
+using namespace std;
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define LIFE_SIMD_X86 1
+#include <immintrin.h>
+#endif
+
+#include "life-constants.h"  // for kMaxAge
+#include "life-simd.h"
+#include "life-bitwise.h"    // for lowestBit
+#include "life-shape.h"      // for ShapeTracker
+
+/**
+ * Function: markFlips
+ * -------------------
+ * Sets the bits of flips for the cells starting at first whose bits are
+ * set in mask, which may reach into the next word.
+ */
+static inline void markFlips(uint64_t* flips, int first, uint64_t mask) {
+    int shift = first % 64;
+    flips[first / 64] |= mask << shift;
+    if (shift != 0 && (mask >> (64 - shift)) != 0) {
+        flips[first / 64 + 1] |= mask >> (64 - shift);
+    }
+}
+
+/**
+ * Function: countLaneChanges
+ * --------------------------
+ * Moves the cells starting at first whose bits are set in lanes from
+ * ageCounts[their age in mid] to ageCounts[their age in out].
+ */
+static inline void countLaneChanges(long long* ageCounts, const uint8_t* mid, const uint8_t* out, int first,
+                                    uint32_t lanes) {
+    for (; lanes != 0; lanes &= lanes - 1) {
+        int i = first + lowestBit(lanes);
+        ageCounts[mid[i]]--;
+        ageCounts[out[i]]++;
+    }
+}
+
+/**
+ * Function: scalarRow
+ * -------------------
+ * Steps cells first through count - 1 one at a time.  This is the fallback
+ * for CPUs without vector support and finishes the tail of each row for
+ * the vector kernels.
+ */
+static bool scalarRow(const uint8_t* up, const uint8_t* mid, const uint8_t* down, uint8_t* out, int first,
+                      int count, const LifeRule& rule, uint64_t* flips, long long* ageCounts) {
+    bool changed = false;
+    for (int i = first; i < count; i++) {
+        int neighbors = (up[i - 1] > 0) + (up[i] > 0) + (up[i + 1] > 0)
+                + (mid[i - 1] > 0) + (mid[i + 1] > 0)
+                + (down[i - 1] > 0) + (down[i] > 0) + (down[i + 1] > 0);
+        int age = mid[i];
+        int next = nextAge(rule, age, neighbors);
+        out[i] = static_cast<uint8_t>(next);
+        changed |= (next != age);
+        if ((next > 0) != (age > 0)) {
+            flips[i / 64] |= 1ULL << (i % 64);
+        }
+        if (ageCounts != nullptr) {
+            ageCounts[age]--;
+            ageCounts[next]++;
+        }
+    }
+    return changed;
+}
+
+#ifdef LIFE_SIMD_X86
+
+/**
+ * Function: sse2CountIn
+ * ---------------------
+ * Returns 0xff in each lane whose neighbor count is one of the counts in
+ * mask.  It is always inlined, so when mask is a constant the other
+ * comparisons compile away.
+ */
+__attribute__((target("sse2"), always_inline))
+static inline __m128i sse2CountIn(unsigned int mask, __m128i sum) {
+    __m128i matches = _mm_setzero_si128();
+    if (mask & (1 << 0)) matches = _mm_or_si128(matches, _mm_cmpeq_epi8(sum, _mm_set1_epi8(0)));
+    if (mask & (1 << 1)) matches = _mm_or_si128(matches, _mm_cmpeq_epi8(sum, _mm_set1_epi8(1)));
+    if (mask & (1 << 2)) matches = _mm_or_si128(matches, _mm_cmpeq_epi8(sum, _mm_set1_epi8(2)));
+    if (mask & (1 << 3)) matches = _mm_or_si128(matches, _mm_cmpeq_epi8(sum, _mm_set1_epi8(3)));
+    if (mask & (1 << 4)) matches = _mm_or_si128(matches, _mm_cmpeq_epi8(sum, _mm_set1_epi8(4)));
+    if (mask & (1 << 5)) matches = _mm_or_si128(matches, _mm_cmpeq_epi8(sum, _mm_set1_epi8(5)));
+    if (mask & (1 << 6)) matches = _mm_or_si128(matches, _mm_cmpeq_epi8(sum, _mm_set1_epi8(6)));
+    if (mask & (1 << 7)) matches = _mm_or_si128(matches, _mm_cmpeq_epi8(sum, _mm_set1_epi8(7)));
+    if (mask & (1 << 8)) matches = _mm_or_si128(matches, _mm_cmpeq_epi8(sum, _mm_set1_epi8(8)));
+    return matches;
+}
+
+/**
+ * Function: sse2Row
+ * -----------------
+ * Steps 16 cells per iteration using SSE2 byte lanes.  Birth and Survival
+ * give the rule at compile time, or are kAnyRule to read it from rule.
+ */
+template <unsigned int Birth, unsigned int Survival>
+__attribute__((target("sse2")))
+static bool sse2Row(const uint8_t* up, const uint8_t* mid, const uint8_t* down, uint8_t* out, int first,
+                    int count, const LifeRule& rule, uint64_t* flips, long long* ageCounts) {
+    const unsigned int birth = (Birth == kAnyRule) ? rule.birth : Birth;
+    const unsigned int survival = (Survival == kAnyRule) ? rule.survival : Survival;
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i one = _mm_set1_epi8(1);
+    const __m128i maxAge = _mm_set1_epi8(kMaxAge);
+    __m128i diff = _mm_setzero_si128();
+    int i = first;
+    for (; i + 16 <= count; i += 16) {
+        const uint8_t* rowsAt[] = { up + i, mid + i, down + i };
+        __m128i sum = _mm_setzero_si128();
+        for (int k = 0; k < 3; k++) {
+            sum = _mm_add_epi8(sum, _mm_min_epu8(_mm_loadu_si128((const __m128i*) (rowsAt[k] - 1)), one));
+            if (k != 1) {
+                sum = _mm_add_epi8(sum, _mm_min_epu8(_mm_loadu_si128((const __m128i*) rowsAt[k]), one));
+            }
+            sum = _mm_add_epi8(sum, _mm_min_epu8(_mm_loadu_si128((const __m128i*) (rowsAt[k] + 1)), one));
+        }
+        __m128i age = _mm_loadu_si128((const __m128i*) (mid + i));
+        __m128i keep = sse2CountIn(survival, sum);
+        __m128i grow = sse2CountIn(birth, sum);
+        if ((birth & ~survival) != 0) {
+            // a live cell whose count gives birth but not survival dies
+            grow = _mm_and_si128(grow, _mm_or_si128(keep, _mm_cmpeq_epi8(age, zero)));
+        }
+        __m128i next = _mm_add_epi8(_mm_and_si128(age, keep), _mm_and_si128(grow, one));
+        next = _mm_min_epu8(next, maxAge);
+        _mm_storeu_si128((__m128i*) (out + i), next);
+        diff = _mm_or_si128(diff, _mm_xor_si128(next, age));
+        __m128i flipped = _mm_xor_si128(_mm_cmpeq_epi8(next, zero), _mm_cmpeq_epi8(age, zero));
+        markFlips(flips, i, static_cast<uint32_t>(_mm_movemask_epi8(flipped)));
+        if (ageCounts != nullptr) {
+            uint32_t moved = static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(next, age))) ^ 0xffff;
+            countLaneChanges(ageCounts, mid, out, i, moved);
+        }
+    }
+    bool changed = _mm_movemask_epi8(_mm_cmpeq_epi8(diff, _mm_setzero_si128())) != 0xffff;
+    return scalarRow(up, mid, down, out, i, count, rule, flips, ageCounts) || changed;
+}
+
+/**
+ * Function: avx2CountIn
+ * ---------------------
+ * Works like sse2CountIn on AVX2 byte lanes.
+ */
+__attribute__((target("avx2"), always_inline))
+static inline __m256i avx2CountIn(unsigned int mask, __m256i sum) {
+    __m256i matches = _mm256_setzero_si256();
+    if (mask & (1 << 0)) matches = _mm256_or_si256(matches, _mm256_cmpeq_epi8(sum, _mm256_set1_epi8(0)));
+    if (mask & (1 << 1)) matches = _mm256_or_si256(matches, _mm256_cmpeq_epi8(sum, _mm256_set1_epi8(1)));
+    if (mask & (1 << 2)) matches = _mm256_or_si256(matches, _mm256_cmpeq_epi8(sum, _mm256_set1_epi8(2)));
+    if (mask & (1 << 3)) matches = _mm256_or_si256(matches, _mm256_cmpeq_epi8(sum, _mm256_set1_epi8(3)));
+    if (mask & (1 << 4)) matches = _mm256_or_si256(matches, _mm256_cmpeq_epi8(sum, _mm256_set1_epi8(4)));
+    if (mask & (1 << 5)) matches = _mm256_or_si256(matches, _mm256_cmpeq_epi8(sum, _mm256_set1_epi8(5)));
+    if (mask & (1 << 6)) matches = _mm256_or_si256(matches, _mm256_cmpeq_epi8(sum, _mm256_set1_epi8(6)));
+    if (mask & (1 << 7)) matches = _mm256_or_si256(matches, _mm256_cmpeq_epi8(sum, _mm256_set1_epi8(7)));
+    if (mask & (1 << 8)) matches = _mm256_or_si256(matches, _mm256_cmpeq_epi8(sum, _mm256_set1_epi8(8)));
+    return matches;
+}
+
+/**
+ * Function: avx2Row
+ * -----------------
+ * Steps 32 cells per iteration using AVX2 byte lanes.
+ */
+template <unsigned int Birth, unsigned int Survival>
+__attribute__((target("avx2")))
+static bool avx2Row(const uint8_t* up, const uint8_t* mid, const uint8_t* down, uint8_t* out, int first,
+                    int count, const LifeRule& rule, uint64_t* flips, long long* ageCounts) {
+    const unsigned int birth = (Birth == kAnyRule) ? rule.birth : Birth;
+    const unsigned int survival = (Survival == kAnyRule) ? rule.survival : Survival;
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i one = _mm256_set1_epi8(1);
+    const __m256i maxAge = _mm256_set1_epi8(kMaxAge);
+    __m256i diff = _mm256_setzero_si256();
+    int i = first;
+    for (; i + 32 <= count; i += 32) {
+        const uint8_t* rowsAt[] = { up + i, mid + i, down + i };
+        __m256i sum = _mm256_setzero_si256();
+        for (int k = 0; k < 3; k++) {
+            sum = _mm256_add_epi8(sum, _mm256_min_epu8(_mm256_loadu_si256((const __m256i*) (rowsAt[k] - 1)), one));
+            if (k != 1) {
+                sum = _mm256_add_epi8(sum, _mm256_min_epu8(_mm256_loadu_si256((const __m256i*) rowsAt[k]), one));
+            }
+            sum = _mm256_add_epi8(sum, _mm256_min_epu8(_mm256_loadu_si256((const __m256i*) (rowsAt[k] + 1)), one));
+        }
+        __m256i age = _mm256_loadu_si256((const __m256i*) (mid + i));
+        __m256i keep = avx2CountIn(survival, sum);
+        __m256i grow = avx2CountIn(birth, sum);
+        if ((birth & ~survival) != 0) {
+            grow = _mm256_and_si256(grow, _mm256_or_si256(keep, _mm256_cmpeq_epi8(age, zero)));
+        }
+        __m256i next = _mm256_add_epi8(_mm256_and_si256(age, keep), _mm256_and_si256(grow, one));
+        next = _mm256_min_epu8(next, maxAge);
+        _mm256_storeu_si256((__m256i*) (out + i), next);
+        diff = _mm256_or_si256(diff, _mm256_xor_si256(next, age));
+        __m256i flipped = _mm256_xor_si256(_mm256_cmpeq_epi8(next, zero), _mm256_cmpeq_epi8(age, zero));
+        markFlips(flips, i, static_cast<uint32_t>(_mm256_movemask_epi8(flipped)));
+        if (ageCounts != nullptr) {
+            uint32_t moved = ~static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(next, age)));
+            countLaneChanges(ageCounts, mid, out, i, moved);
+        }
+    }
+    bool changed = !_mm256_testz_si256(diff, diff);
+    return sse2Row<Birth, Survival>(up, mid, down, out, i, count, rule, flips, ageCounts) || changed;
+}
+
+#endif // LIFE_SIMD_X86
+
+SimdLifeEngine::SimdLifeEngine()
+        : rows(0), cols(0), rowStride(2), countingAges(false), wrapping(false), rule(kConwayRule) {
+    clearStats(counts);
+    kernel = selectKernel(kernelType, rule);
+}
+
+/**
+ * Function: selectRuleKernel
+ * --------------------------
+ * Returns the kernel of the given width specialized for Birth/Survival.
+ */
+template <unsigned int Birth, unsigned int Survival>
+static SimdLifeEngine::RowKernel selectRuleKernel(const string& kernelName) {
+#ifdef LIFE_SIMD_X86
+    if (kernelName == "avx2") {
+        return avx2Row<Birth, Survival>;
+    } else if (kernelName == "sse2") {
+        return sse2Row<Birth, Survival>;
+    }
+#endif // LIFE_SIMD_X86
+    (void) kernelName;
+    return scalarRow;
+}
+
+SimdLifeEngine::RowKernel SimdLifeEngine::selectKernel(string& kernelName, const LifeRule& rule) {
+    kernelName = "scalar";
+#ifdef LIFE_SIMD_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        kernelName = "avx2";
+    } else if (__builtin_cpu_supports("sse2")) {
+        kernelName = "sse2";
+    }
+#endif // LIFE_SIMD_X86
+
+#define LIFE_SELECT_RULE(B, S) \
+    if (rule.birth == (B) && rule.survival == (S)) { \
+        return selectRuleKernel<(B), (S)>(kernelName); \
+    }
+    LIFE_SPECIALIZED_RULES(LIFE_SELECT_RULE)
+#undef LIFE_SELECT_RULE
+    return selectRuleKernel<kAnyRule, kAnyRule>(kernelName);
+}
+
+void SimdLifeEngine::fillBorder(vector<uint8_t>& plane, int rows, int cols, bool wrap) {
+    if (rows == 0 || cols == 0) {
+        return;
+    }
+    size_t stride = cols + 2;
+    for (int r = 1; r <= rows; r++) {
+        uint8_t* row = &plane[r * stride];
+        row[0] = wrap ? row[cols] : 0;
+        row[cols + 1] = wrap ? row[1] : 0;
+    }
+    // the corners come along with the rows, as they were filled above
+    uint8_t* top = &plane[0];
+    uint8_t* bottom = &plane[(rows + 1) * stride];
+    if (wrap) {
+        memcpy(top, &plane[rows * stride], stride);
+        memcpy(bottom, &plane[stride], stride);
+    } else {
+        memset(top, 0, stride);
+        memset(bottom, 0, stride);
+    }
+}
+
+void SimdLifeEngine::countAges(const vector<uint8_t>& plane, int rows, int cols, long long* ageCounts) {
+    for (int age = 0; age <= kMaxAge; age++) {
+        ageCounts[age] = 0;
+    }
+    size_t stride = cols + 2;
+    for (int r = 1; r <= rows; r++) {
+        const uint8_t* row = &plane[r * stride];
+        for (int c = 1; c <= cols; c++) {
+            ageCounts[row[c]]++;
+        }
+    }
+}
+
+string SimdLifeEngine::name() const {
+    return "simd";
+}
+
+string SimdLifeEngine::kernelName() const {
+    return kernelType;
+}
+
+void SimdLifeEngine::load(const Grid<int>& board) {
+    rows = board.numRows();
+    cols = board.numCols();
+    rowStride = cols + 2;
+    ages.assign(static_cast<size_t>(rows + 2) * rowStride, 0);
+    next.assign(ages.size(), 0);
+    flips.assign((cols + 63) / 64, 0);
+    outline.reset(rows, cols);
+    clearStats(counts);
+    countingAges = false;
+    for (int r = 0; r < rows; r++) {
+        for (int c = 0; c < cols; c++) {
+            ages[indexOf(r, c)] = static_cast<uint8_t>(max(0, min(board.get(r, c), kMaxAge)));
+            if (ages[indexOf(r, c)] > 0) {
+                outline.add(r, c);
+            }
+        }
+    }
+}
+
+bool SimdLifeEngine::step() {
+    if (wrapping) {
+        fillBorder(ages, rows, cols, true);
+    }
+    bool changed = false;
+    long long born = 0;
+    long long living = outline.population();
+    long long* ageCounts = countingAges ? counts.ages : nullptr;
+    for (int r = 0; r < rows; r++) {
+        const uint8_t* mid = &ages[indexOf(r, 0)];
+        uint8_t* out = &next[indexOf(r, 0)];
+        if (kernel(mid - rowStride, mid, mid + rowStride, out, 0, cols, rule, flips.data(), ageCounts)) {
+            // flips only has bits when some age changed, so it is cleared only then
+            born += outline.update(r, 0, flips.data(), cols, out);
+            fill(flips.begin(), flips.end(), 0);
+            changed = true;
+        }
+    }
+    ages.swap(next);
+    counts.births = born;
+    counts.deaths = born - (outline.population() - living);
+    return changed;
+}
+
+void SimdLifeEngine::stats(LifeStats& stats) const {
+    if (!countingAges) {
+        countAges(ages, rows, cols, counts.ages);
+        countingAges = true;
+    }
+    stats = counts;
+    stats.population = outline.population();
+}
+
+int SimdLifeEngine::ageAt(int row, int col) const {
+    return ages[indexOf(row, col)];
+}
+
+bool SimdLifeEngine::setRule(const LifeRule& newRule) {
+    rule = newRule;
+    kernel = selectKernel(kernelType, rule);
+    return true;
+}
+
+bool SimdLifeEngine::setWrapping(bool wrap) {
+    wrapping = wrap;
+    if (!wrap) {
+        fillBorder(ages, rows, cols, false);
+        fillBorder(next, rows, cols, false);
+    }
+    return true;
+}
+
+size_t SimdLifeEngine::indexOf(int row, int col) const {
+    return static_cast<size_t>(row + 1) * rowStride + (col + 1);
+}
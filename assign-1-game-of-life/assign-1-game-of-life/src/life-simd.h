@@ -0,0 +1,101 @@
+/**
+ * File: life-simd.h
+ * -----------------
+ * Defines a Life engine that keeps one age byte per cell in a padded,
+ * row-major buffer and steps 16 (SSE2) or 32 (AVX2) cells per instruction.
+ * The widest kernel the CPU supports is chosen at runtime, with a scalar
+ * kernel as the fallback on other processors.
+ */
+
+#pragma once
+#include <cstdint>   // for uint8_t, uint64_t
+#include <string>    // for std::string
+#include <vector>    // for std::vector
+#include "grid.h"    // for Grid
+
+#include "life-engine.h"
+#include "life-shape.h"   // for ShapeTracker
+
+class SimdLifeEngine : public LifeEngine {
+public:
+/**
+ * Constructs an empty engine and selects the kernel for this CPU.
+ */
+    SimdLifeEngine();
+
+    std::string name() const;
+    void load(const Grid<int>& board);
+    bool step();
+    int numRows() const { return rows; }
+    int numCols() const { return cols; }
+    int ageAt(int row, int col) const;
+    long long population() const { return outline.population(); }
+
+/**
+ * Births and deaths are counted as the outline is updated.  The first call after a load counts the ages, and from
+ * then on the kernels move each cell whose age changes between the
+ * counts, so runs that never ask for stats do not pay for keeping them.
+ */
+    void stats(LifeStats& stats) const;
+    void shape(LifeShape& shape) const { outline.fill(shape); }
+    bool setWrapping(bool wrap);
+    bool setRule(const LifeRule& newRule);
+
+/**
+ * Returns the name of the kernel chosen at runtime: "avx2", "sse2" or "scalar".
+ */
+    std::string kernelName() const;
+
+/**
+ * Steps cells first through count - 1 of one row under rule.  Each pointer
+ * addresses column 0 of its row, and the bytes just before and after the
+ * row must be readable.  For every cell i that is born or dies, bit i % 64
+ * of flips[i / 64] is set; the caller clears flips beforehand.  Unless
+ * ageCounts is nullptr, every cell whose age changes is moved from
+ * ageCounts[old age] to ageCounts[new age].  Returns true if any age
+ * changed.
+ */
+    typedef bool (*RowKernel)(const std::uint8_t* up, const std::uint8_t* mid, const std::uint8_t* down,
+                              std::uint8_t* out, int first, int count, const LifeRule& rule,
+                              std::uint64_t* flips, long long* ageCounts);
+
+/**
+ * Returns the widest row kernel this CPU supports for the given rule and
+ * stores its width in kernelName.  Rules listed in LIFE_SPECIALIZED_RULES
+ * get a kernel compiled for them; others get one that reads the rule as it
+ * goes.  Other engines that keep the same byte layout can share these.
+ */
+    static RowKernel selectKernel(std::string& kernelName, const LifeRule& rule);
+
+/**
+ * Refreshes the one-cell border around a rows x cols plane laid out with
+ * a row stride of cols + 2.  If wrap is set, each border cell receives a
+ * copy of the cell on the opposite edge, so the kernels see a torus without
+ * checking bounds; otherwise the border is cleared.
+ */
+    static void fillBorder(std::vector<std::uint8_t>& plane, int rows, int cols, bool wrap);
+
+/**
+ * Fills ageCounts[0] through ageCounts[kMaxAge] with the number of cells
+ * of each age in a plane laid out as for fillBorder, leaving out the
+ * border.
+ */
+    static void countAges(const std::vector<std::uint8_t>& plane, int rows, int cols, long long* ageCounts);
+
+private:
+    int rows;
+    int cols;
+    int rowStride;                    // cols plus a zero column on either side
+    std::vector<std::uint8_t> ages;   // (rows + 2) x rowStride, zero border all around
+    std::vector<std::uint8_t> next;   // scratch plane swapped with ages each step
+    std::vector<std::uint64_t> flips; // births and deaths in the row being stepped
+    ShapeTracker outline;             // updated by each step
+    mutable LifeStats counts;         // births, deaths and, once countingAges is set, ages
+    mutable bool countingAges;        // set by the first call to stats after a load
+    RowKernel kernel;
+    std::string kernelType;
+    bool wrapping;
+    LifeRule rule;
+
+    std::size_t indexOf(int row, int col) const;
+};
@@ -0,0 +1,153 @@
+/**
+ * File: life-simulation.cpp
+ * -------------------------
+ * Implements the threaded simulation.  Capturing a frame reads every
+ * cell, so while the renderer still has an untaken frame, a new one is
+ * only captured once the old one is a display frame old; otherwise fast
+ * engines would spend most of their time copying frames nobody sees.
+ */
+
+#include <string>     // for to_string
+using namespace std;
+
+#include "life-simulation.h"
+#include "life-cycles.h"     // for CycleDetector
+
+const int LifeSimulation::kFrameInterval;   // chrono::milliseconds binds it by reference
+
+LifeSimulation::LifeSimulation(LifeEngine& engine, int delay)
+        : engine(engine), delay(delay), timings(nullptr), stopping(false), done(false), hasPending(false) {
+    // empty
+}
+
+LifeSimulation::~LifeSimulation() {
+    stop();
+}
+
+void LifeSimulation::setTimings(LifeTimings* newTimings) {
+    timings = newTimings;
+}
+
+void LifeSimulation::start() {
+    if (!worker.joinable()) {
+        worker = thread(&LifeSimulation::run, this);
+    }
+}
+
+void LifeSimulation::stop() {
+    {
+        lock_guard<mutex> guard(lock);
+        stopping = true;
+    }
+    wakeup.notify_all();
+    if (worker.joinable()) {
+        worker.join();
+    }
+}
+
+bool LifeSimulation::takeFrame(LifeFrame& frame) {
+    lock_guard<mutex> guard(lock);
+    if (!hasPending) {
+        return false;
+    }
+    swap(frame, pending);
+    hasPending = false;
+    return true;
+}
+
+bool LifeSimulation::finished() const {
+    lock_guard<mutex> guard(lock);
+    return done;
+}
+
+string LifeSimulation::message() const {
+    lock_guard<mutex> guard(lock);
+    return doneMessage;
+}
+
+/**
+ * Body of the simulation thread.  A repeating colony would otherwise run
+ * forever; a spaceship keeps going until it reaches the edge of the board.
+ */
+void LifeSimulation::run() {
+    long long generation = 0;
+    CycleDetector cycles;
+    cycles.observe(engine, generation);
+    string motion;
+    string reason;
+    publish(generation, motion, true);
+
+    while (wait()) {
+        bool changed;
+        {
+            PhaseTimer timer(timings, kStepPhase);
+            changed = engine.step();
+        }
+        if (!changed) {
+            break;
+        }
+        generation += engine.stepSize();
+        if (cycles.observe(engine, generation)) {
+            if (!cycles.isMoving()) {
+                reason = "The colony repeats every " + to_string(cycles.period()) + " generations from generation "
+                         + to_string(cycles.cycleStart()) + ".";
+                break;
+            }
+            motion = ", moving (" + to_string(cycles.rowShift()) + ", " + to_string(cycles.colShift()) +
+                     ") every " + to_string(cycles.period()) + " generations";
+        }
+        publish(generation, motion, false);
+    }
+
+    publish(generation, motion, true);
+    lock_guard<mutex> guard(lock);
+    done = true;
+    doneMessage = reason;
+}
+
+/**
+ * Captures the engine's colony into the pending frame.  Unless force is
+ * set, the capture is skipped while the renderer has a recent frame it
+ * has not taken yet.
+ */
+void LifeSimulation::publish(long long generation, const string& motion, bool force) {
+    chrono::steady_clock::time_point now = chrono::steady_clock::now();
+    {
+        lock_guard<mutex> guard(lock);
+        if (!force && hasPending && now - pendingTime < chrono::milliseconds(kFrameInterval)) {
+            return;
+        }
+    }
+
+    PhaseTimer timer(timings, kCapturePhase);
+    int rows = engine.numRows();
+    int cols = engine.numCols();
+    scratch.generation = generation;
+    scratch.population = engine.population();
+    scratch.rows = rows;
+    scratch.cols = cols;
+    scratch.motion = motion;
+    scratch.ages.resize(static_cast<size_t>(rows) * cols);
+    for (int r = 0; r < rows; r++) {
+        for (int c = 0; c < cols; c++) {
+            scratch.ages[static_cast<size_t>(r) * cols + c] = static_cast<uint8_t>(engine.ageAt(r, c));
+        }
+    }
+
+    lock_guard<mutex> guard(lock);
+    swap(scratch, pending);
+    hasPending = true;
+    pendingTime = now;
+}
+
+/**
+ * Waits out the delay between generations.  Returns false if the
+ * simulation is being stopped.
+ */
+bool LifeSimulation::wait() {
+    unique_lock<mutex> guard(lock);
+    if (delay > 0) {
+        wakeup.wait_for(guard, chrono::milliseconds(delay), [this] { return stopping; });
+    }
+    return !stopping;
+}
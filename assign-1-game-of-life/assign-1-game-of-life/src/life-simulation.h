@@ -0,0 +1,110 @@
+/**
+ * File: life-simulation.h
+ * -----------------------
+ * Defines a simulation that steps an engine on its own thread, so that
+ * the speed of the simulation no longer depends on how fast generations
+ * can be drawn.  The thread hands generations to the renderer through a
+ * latest-frame-wins buffer: a new frame replaces any frame the renderer
+ * has not taken yet, so a slow renderer skips generations instead of
+ * holding the simulation back.
+ */
+
+#pragma once
+#include <chrono>              // for std::chrono::steady_clock
+#include <condition_variable>  // for std::condition_variable
+#include <cstdint>             // for uint8_t
+#include <mutex>               // for std::mutex
+#include <string>              // for std::string
+#include <thread>              // for std::thread
+#include <vector>              // for std::vector
+
+#include "life-engine.h"
+#include "life-timing.h"
+
+/**
+ * A snapshot of one generation, ready to be drawn.
+ */
+struct LifeFrame {
+    long long generation;
+    long long population;
+    int rows;
+    int cols;
+    std::vector<std::uint8_t> ages;   // rows x cols, row by row
+    std::string motion;               // describes a moving cycle once one is found
+};
+
+class LifeSimulation {
+public:
+/**
+ * Prepares to run the engine, which must stay alive and must not be used
+ * elsewhere until the simulation is destroyed.  The thread waits delay
+ * milliseconds after each step; 0 runs it as fast as the engine can go.
+ */
+    LifeSimulation(LifeEngine& engine, int delay);
+
+/**
+ * Stops the simulation thread and waits for it to finish.
+ */
+    ~LifeSimulation();
+
+/**
+ * Times each step and frame capture in timings, which must outlive the
+ * simulation.  Must be called before start.
+ */
+    void setTimings(LifeTimings* timings);
+
+/**
+ * Starts the simulation thread.  The first frame is the loaded colony.
+ */
+    void start();
+
+/**
+ * Stops the simulation thread after its current step.
+ */
+    void stop();
+
+/**
+ * Moves the newest frame that has not been taken yet into frame and
+ * returns true, or returns false if there is none.  Frames replaced
+ * before they were taken are dropped.
+ */
+    bool takeFrame(LifeFrame& frame);
+
+/**
+ * Returns true once the colony has stabilized or settled into a stationary
+ * cycle.  The frame showing the final generation is published before this
+ * becomes true.
+ */
+    bool finished() const;
+
+/**
+ * Returns the reason the simulation finished, or "" if there is nothing to
+ * report (e.g. the colony simply stopped changing).
+ */
+    std::string message() const;
+
+private:
+    LifeEngine& engine;
+    int delay;
+    LifeTimings* timings;             // null if nothing is timed
+    std::thread worker;
+    mutable std::mutex lock;
+    std::condition_variable wakeup;   // cuts the delay short when stopping
+    bool stopping;
+    bool done;
+    std::string doneMessage;
+
+    LifeFrame scratch;                // filled by the simulation thread
+    LifeFrame pending;                // newest frame not yet taken
+    bool hasPending;
+    std::chrono::steady_clock::time_point pendingTime;   // when pending was captured
+
+    static const int kFrameInterval = 16;   // milliseconds between frames the renderer has not taken
+
+    void run();
+    void publish(long long generation, const std::string& motion, bool force);
+    bool wait();
+
+    LifeSimulation(const LifeSimulation& original);
+    void operator=(const LifeSimulation& rhs) const;
+};
@@ -0,0 +1,325 @@
+/**
+ * File: life-soup.cpp
+ * -------------------
+ * Implements the soup-search batch mode.  Workers take soup numbers from
+ * a shared counter, so fast and slow soups even out across threads, and
+ * each worker keeps its own engine, cycle detector and random generator.
+ * Finished soups go to a SoupWriter, which writes each CSV line as soon as
+ * every earlier soup has been written, so only the soups that finished out
+ * of order are ever held in memory and an interrupted run keeps the lines
+ * written so far.
+ */
+
+#include <algorithm>  // for max
+#include <atomic>     // for atomic
+#include <chrono>     // for steady_clock
+#include <condition_variable>  // for condition_variable
+#include <fstream>    // for ofstream
+#include <iomanip>    // for setprecision
+#include <iostream>   // for cout
+#include <map>        // for map
+#include <mutex>      // for mutex, lock_guard, unique_lock
+#include <sstream>    // for ostringstream
+#include <thread>     // for thread
+#include <vector>     // for vector
+using namespace std;
+#include "console.h"  // for setConsoleEcho
+#include "grid.h"     // for Grid
+#include "strlib.h"   // for stringIsInteger, stringToInteger, stringIsLong, stringToLong
+
+#include "life-soup.h"
+#include "life-args.h"       // for parseBoardSize
+#include "life-cycles.h"     // for CycleDetector
+#include "life-engine.h"     // for createLifeEngine, lifeEngineNames
+#include "life-patterns.h"   // for fillRandomGrid
+#include "life-random.h"     // for LifeRandom
+#include "life-rules.h"      // for parseLifeRule
+
+/**
+ * What happened to one soup.
+ */
+struct SoupResult {
+    int rows;
+    int cols;
+    long long initialPopulation;
+    long long stableGeneration;    // -1 if the soup never settled
+    long long finalPopulation;
+    long long period;
+};
+
+/**
+ * The settings shared by every worker.
+ */
+struct SoupSettings {
+    long long soups;
+    int rows;                      // 0 for a random size
+    int cols;
+    uint64_t seed;
+    string engineName;
+    long long maxGenerations;
+    LifeRule rule;
+    bool wrap;
+};
+
+/**
+ * Writes the results to the CSV in soup order as the workers hand them in
+ * and keeps the totals for the summary.  A worker that gets too far ahead
+ * of the oldest unfinished soup waits, so at most kMaxPending results are
+ * held at once.
+ */
+class SoupWriter {
+public:
+    SoupWriter(ostream& csv);
+    void waitForRoom(long long soup);
+    void add(long long soup, const SoupResult& result);
+
+    map<long long, long long> periods;    // settled soups by period
+    long long generations;                // total generations to settle
+    long long unsettled;
+
+private:
+    static const long long kMaxPending = 4096;
+    static const long long kFlushInterval = 1024;
+
+    ostream& csv;
+    mutex lock;
+    condition_variable written;
+    map<long long, SoupResult> pending;   // finished soups waiting for an earlier one
+    long long nextSoup;                   // the next soup to be written
+
+    void write(long long soup, const SoupResult& result);
+
+    SoupWriter(const SoupWriter& original);
+    void operator=(const SoupWriter& rhs) const;
+};
+
+static void searchSoups(const SoupSettings& settings, atomic<long long>& nextSoup, SoupWriter& writer);
+static void runSoup(LifeEngine& engine, CycleDetector& cycles, long long maxGenerations, SoupResult& result);
+static void printUsage();
+
+int runSoupSearch(const Vector<string>& args) {
+    setConsoleEcho(true);
+
+    SoupSettings settings;
+    settings.soups = 1000;
+    settings.rows = 0;
+    settings.cols = 0;
+    settings.seed = 1;
+    settings.engineName = "bitboard";
+    settings.maxGenerations = 10000;
+    settings.rule = kConwayRule;
+    settings.wrap = false;
+    int threads = 0;
+    string csvName = "soups.csv";
+    for (int i = 0; i < args.size(); i++) {
+        bool hasValue = i + 1 < args.size();
+        if (args[i] == "--soup") {
+            continue;
+        } else if (args[i] == "--soups" && hasValue && stringIsLong(args[i + 1])) {
+            settings.soups = stringToLong(args[++i]);
+        } else if (args[i] == "--size" && hasValue && parseBoardSize(args[i + 1], settings.rows, settings.cols)) {
+            i++;
+        } else if (args[i] == "--seed" && hasValue && stringIsLong(args[i + 1])) {
+            settings.seed = static_cast<uint64_t>(stringToLong(args[++i]));
+        } else if (args[i] == "--threads" && hasValue && stringIsInteger(args[i + 1])) {
+            threads = stringToInteger(args[++i]);
+        } else if (args[i] == "--engine" && hasValue) {
+            settings.engineName = args[++i];
+        } else if (args[i] == "--max-generations" && hasValue && stringIsLong(args[i + 1])) {
+            settings.maxGenerations = stringToLong(args[++i]);
+        } else if (args[i] == "--rule" && hasValue) {
+            if (!parseLifeRule(args[++i], settings.rule)) {
+                cout << "Error. " << args[i] << " isn't a B/S rule." << endl;
+                return 1;
+            }
+        } else if (args[i] == "--wrap") {
+            settings.wrap = true;
+        } else if (args[i] == "--csv" && hasValue) {
+            csvName = args[++i];
+        } else {
+            printUsage();
+            return 1;
+        }
+    }
+    if (settings.soups < 0 || settings.maxGenerations < 0) {
+        printUsage();
+        return 1;
+    }
+    if (threads <= 0) {
+        threads = max(1, static_cast<int>(thread::hardware_concurrency()));
+    }
+    if (!lifeEngineNames().contains(settings.engineName)) {
+        cout << "Error. There is no engine called " << settings.engineName << "." << endl;
+        return 1;
+    }
+
+    // check the engine once up front rather than in every worker
+    LifeEngine* probe = createLifeEngine(settings.engineName);
+    bool supported = probe->setRule(settings.rule) && probe->setWrapping(settings.wrap);
+    delete probe;
+    if (!supported) {
+        cout << "Error. The " << settings.engineName << " engine can't simulate " << lifeRuleString(settings.rule)
+             << (settings.wrap ? " wrapped around." : ".") << endl;
+        return 1;
+    }
+    ofstream csv(csvName.c_str());
+    if (csv.fail()) {
+        cout << "Error. Couldn't write " << csvName << "." << endl;
+        return 1;
+    }
+
+    csv << "soup,rows,cols,initial_population,stable_generation,final_population,period\n";
+    SoupWriter writer(csv);
+    atomic<long long> nextSoup(0);
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    vector<thread> workers;
+    for (int id = 1; id < threads; id++) {
+        workers.push_back(thread(searchSoups, cref(settings), ref(nextSoup), ref(writer)));
+    }
+    searchSoups(settings, nextSoup, writer);
+    for (size_t i = 0; i < workers.size(); i++) {
+        workers[i].join();
+    }
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    csv.close();
+    if (csv.fail()) {
+        cout << "Error. Couldn't write " << csvName << "." << endl;
+        return 1;
+    }
+
+    // format into a local stream so that the console's formatting is left alone
+    ostringstream report;
+    report << fixed << setprecision(3);
+    report << "engine:          " << settings.engineName << endl;
+    report << "rule:            " << lifeRuleString(settings.rule) << (settings.wrap ? ", wrapped" : "") << endl;
+    report << "soups:           " << settings.soups << " on " << threads << " threads, seed " << settings.seed << endl;
+    report << "run time:        " << seconds << " s" << endl;
+    report << "soups/sec:       " << settings.soups / seconds << endl;
+    long long settled = settings.soups - writer.unsettled;
+    if (settled > 0) {
+        report << "mean settling:   " << static_cast<double>(writer.generations) / settled
+               << " generations" << endl;
+    }
+    report << "unsettled:       " << writer.unsettled << " after " << settings.maxGenerations << " generations" << endl;
+    for (map<long long, long long>::iterator it = writer.periods.begin(); it != writer.periods.end(); ++it) {
+        report << "period " << setw(10) << left << (to_string(it->first) + ":") << right << it->second << endl;
+    }
+    report << "results:         " << csvName << endl;
+    cout << report.str();
+    return 0;
+}
+
+SoupWriter::SoupWriter(ostream& csv) : generations(0), unsettled(0), csv(csv), nextSoup(0) {
+}
+
+/**
+ * Blocks until the given soup is close enough to the next one to be
+ * written that its result may be held.  The soup being waited for has
+ * already been taken by a worker that does not have to wait itself.
+ */
+void SoupWriter::waitForRoom(long long soup) {
+    unique_lock<mutex> guard(lock);
+    while (soup >= nextSoup + kMaxPending) {
+        written.wait(guard);
+    }
+}
+
+/**
+ * Hands in a finished soup.  Writes it, and any later soups it was
+ * holding back, if every earlier soup has been written, and otherwise
+ * keeps it until then.
+ */
+void SoupWriter::add(long long soup, const SoupResult& result) {
+    lock_guard<mutex> guard(lock);
+    if (soup != nextSoup) {
+        pending[soup] = result;
+        return;
+    }
+    write(soup, result);
+    map<long long, SoupResult>::iterator it;
+    while ((it = pending.find(nextSoup)) != pending.end()) {
+        write(it->first, it->second);
+        pending.erase(it);
+    }
+    written.notify_all();
+}
+
+/**
+ * Writes one CSV line, adds the soup to the totals and moves on to the
+ * next soup.  The caller holds the lock.
+ */
+void SoupWriter::write(long long soup, const SoupResult& result) {
+    csv << soup << ',' << result.rows << ',' << result.cols << ',' << result.initialPopulation << ',';
+    if (result.stableGeneration >= 0) {
+        csv << result.stableGeneration;
+        periods[result.period]++;
+        generations += result.stableGeneration;
+    } else {
+        unsettled++;
+    }
+    csv << ',' << result.finalPopulation << ',' << result.period << '\n';
+    nextSoup++;
+    if (nextSoup % kFlushInterval == 0) {
+        csv.flush();
+    }
+}
+
+/**
+ * Body of each worker: runs soups until the counter passes the last one.
+ * Soup k always uses stream k of the seed, whichever worker runs it.
+ */
+static void searchSoups(const SoupSettings& settings, atomic<long long>& nextSoup, SoupWriter& writer) {
+    LifeEngine* engine = createLifeEngine(settings.engineName);
+    engine->setRule(settings.rule);
+    engine->setWrapping(settings.wrap);
+    CycleDetector cycles;
+    LifeRandom random;
+    Grid<int> board;
+    SoupResult result;
+    long long soup;
+    while ((soup = nextSoup++) < settings.soups) {
+        writer.waitForRoom(soup);
+        random.reseed(settings.seed, static_cast<uint64_t>(soup));
+        result.rows = (settings.rows > 0) ? settings.rows : random.nextInteger(40, 60);
+        result.cols = (settings.cols > 0) ? settings.cols : random.nextInteger(40, 60);
+        fillRandomGrid(board, result.rows, result.cols, random);
+        engine->load(board);
+        runSoup(*engine, cycles, settings.maxGenerations, result);
+        writer.add(soup, result);
+    }
+    delete engine;
+}
+
+/**
+ * Steps the loaded soup until it repeats, possibly shifted, or the limit
+ * is reached, and records the outcome.
+ */
+static void runSoup(LifeEngine& engine, CycleDetector& cycles, long long maxGenerations, SoupResult& result) {
+    result.initialPopulation = engine.population();
+    result.stableGeneration = -1;
+    result.period = 0;
+    cycles.clear();
+    long long generation = 0;
+    cycles.observe(engine, generation);
+    while (generation < maxGenerations) {
+        bool changed = engine.step();
+        generation += engine.stepSize();
+        if (!changed) {
+            result.stableGeneration = generation - engine.stepSize();
+            result.period = 1;
+            break;
+        }
+        if (cycles.observe(engine, generation)) {
+            result.stableGeneration = cycles.cycleStart();
+            result.period = cycles.period();
+            break;
+        }
+    }
+    result.finalPopulation = engine.population();
+}
+
+static void printUsage() {
+    cout << "Usage: life --soup [--soups N] [--size ROWSxCOLS] [--seed N] [--threads N]" << endl;
+    cout << "            [--engine NAME] [--max-generations N] [--rule B3/S23] [--wrap]" << endl;
+    cout << "            [--csv PATH]" << endl;
+}
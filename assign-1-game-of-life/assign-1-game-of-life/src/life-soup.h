@@ -0,0 +1,38 @@
+/**
+ * File: life-soup.h
+ * -----------------
+ * Defines the soup-search batch mode of the Game of Life.  It runs many
+ * random starting colonies ("soups") until each one settles down, spread
+ * across all cores, and writes one CSV line per soup for census studies.
+ */
+
+#pragma once
+#include <string>    // for std::string
+#include "vector.h"  // for Vector
+
+/**
+ * Runs the soup search described by args and returns the exit status.
+ * Recognized arguments:
+ *
+ *   --soup                   select this mode
+ *   --soups N                number of soups to run (default 1000)
+ *   --size ROWSxCOLS         board size (default a random 40 to 60 each way, as in
+ *                            the interactive mode)
+ *   --seed N                 soup k is built from stream k of this seed (default 1)
+ *   --threads N              worker threads (default one per core)
+ *   --engine NAME            engine each worker runs (default bitboard)
+ *   --max-generations N      give up on a soup after this many generations (default 10000)
+ *   --rule RULE              birth/survival rule, e.g. B36/S23 (default B3/S23)
+ *   --wrap                   wrap the board around at its edges like a torus
+ *   --csv PATH               where to write the results (default soups.csv)
+ *
+ * The CSV has the columns soup, rows, cols, initial_population,
+ * stable_generation, final_population and period.  A soup is stable from
+ * the first generation of the cycle it ends in, and a colony that stops
+ * changing has period 1.  Soups that do not settle within the limit have
+ * an empty stable_generation and period 0.  Lines are written in soup
+ * order while the search runs, so a run that is cut short leaves the soups
+ * finished so far.  Results do not depend on the number of threads.  A
+ * summary is printed to the console.
+ */
+int runSoupSearch(const Vector<std::string>& args);
@@ -0,0 +1,103 @@
+/**
+ * File: life-timing.cpp
+ * ---------------------
+ * Implements the per-phase timers.  Each phase keeps its recent
+ * durations in a ring buffer under its own lock, so the simulation thread
+ * timing steps never waits on the thread timing the drawing.
+ */
+
+#include <algorithm>  // for nth_element, max_element
+#include <iomanip>    // for setw, setprecision
+#include <sstream>    // for ostringstream
+using namespace std;
+
+#include "life-timing.h"
+
+/**
+ * Names of the phases in reports, in LifePhase order.
+ */
+static const char* const kPhaseNames[kNumPhases] = { "step", "capture", "draw", "repaint" };
+
+static double percentile(vector<double>& durations, double fraction);
+
+LifeTimings::LifeTimings() : enabled(false) {
+    for (int i = 0; i < kNumPhases; i++) {
+        phases[i].count = 0;
+        phases[i].recent.reserve(kWindowSize);
+        phases[i].next = 0;
+    }
+}
+
+void LifeTimings::setEnabled(bool on) {
+    enabled = on;
+}
+
+bool LifeTimings::isEnabled() const {
+    return enabled;
+}
+
+void LifeTimings::record(LifePhase phase, double seconds) {
+    PhaseSamples& samples = phases[phase];
+    lock_guard<mutex> guard(samples.lock);
+    samples.count++;
+    if (samples.recent.size() < kWindowSize) {
+        samples.recent.push_back(seconds);
+    } else {
+        samples.recent[samples.next] = seconds;
+        samples.next = (samples.next + 1) % kWindowSize;
+    }
+}
+
+void LifeTimings::report(ostream& out) const {
+    // format into a local stream so that the caller's formatting is left alone
+    ostringstream table;
+    table << fixed << setprecision(3);
+    table << left << setw(10) << "phase" << right << setw(10) << "count" << setw(10) << "mean ms"
+          << setw(10) << "p50 ms" << setw(10) << "p95 ms" << setw(10) << "p99 ms" << setw(10) << "max ms" << endl;
+    for (int i = 0; i < kNumPhases; i++) {
+        long long count;
+        vector<double> recent;
+        {
+            lock_guard<mutex> guard(phases[i].lock);
+            count = phases[i].count;
+            recent = phases[i].recent;
+        }
+        if (recent.empty()) {
+            continue;
+        }
+        double total = 0;
+        for (size_t j = 0; j < recent.size(); j++) {
+            total += recent[j];
+        }
+        double mean = total / recent.size();
+        double largest = *max_element(recent.begin(), recent.end());
+        table << left << setw(10) << kPhaseNames[i] << right << setw(10) << count
+            << setw(10) << mean * 1000 << setw(10) << percentile(recent, 0.50) * 1000
+            << setw(10) << percentile(recent, 0.95) * 1000 << setw(10) << percentile(recent, 0.99) * 1000
+            << setw(10) << largest * 1000 << endl;
+    }
+    out << table.str();
+}
+
+/**
+ * Returns the given fraction's nearest-rank percentile of the durations,
+ * which are partially reordered.
+ */
+static double percentile(vector<double>& durations, double fraction) {
+    size_t rank = static_cast<size_t>(fraction * (durations.size() - 1) + 0.5);
+    nth_element(durations.begin(), durations.begin() + rank, durations.end());
+    return durations[rank];
+}
+
+PhaseTimer::PhaseTimer(LifeTimings* timings, LifePhase phase)
+        : timings((timings != nullptr && timings->isEnabled()) ? timings : nullptr), phase(phase) {
+    if (this->timings != nullptr) {
+        start = chrono::steady_clock::now();
+    }
+}
+
+PhaseTimer::~PhaseTimer() {
+    if (timings != nullptr) {
+        timings->record(phase, chrono::duration<double>(chrono::steady_clock::now() - start).count());
+    }
+}
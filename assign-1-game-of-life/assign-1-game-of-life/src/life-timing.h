@@ -0,0 +1,90 @@
+/**
+ * File: life-timing.h
+ * -------------------
+ * Defines the per-phase timers of the interactive Game of Life, which
+ * show whether a slow frame comes from stepping the colony, copying it
+ * out of the engine, drawing the cells or repainting the window.  Each
+ * phase keeps its most recent durations, from which rolling averages and
+ * percentiles are reported.  Timers that are switched off never read the
+ * clock, so they can stay in place at no real cost.
+ */
+
+#pragma once
+#include <atomic>   // for std::atomic
+#include <chrono>   // for std::chrono::steady_clock
+#include <mutex>    // for std::mutex
+#include <ostream>  // for std::ostream
+#include <vector>   // for std::vector
+
+/**
+ * The parts of a generation that are timed separately.
+ */
+enum LifePhase {
+    kStepPhase,       // engine step, on the simulation thread
+    kCapturePhase,    // copying a generation into a frame
+    kDrawPhase,       // drawing every cell of a frame
+    kRepaintPhase,    // repainting the window
+    kNumPhases
+};
+
+class LifeTimings {
+public:
+/**
+ * Creates a set of timers, which start out switched off.
+ */
+    LifeTimings();
+
+/**
+ * Switches the timers on or off.  Durations already recorded are kept.
+ */
+    void setEnabled(bool enabled);
+    bool isEnabled() const;
+
+/**
+ * Adds one duration, in seconds, to a phase.  Safe to call from any
+ * thread, though each phase is normally timed by a single thread.
+ */
+    void record(LifePhase phase, double seconds);
+
+/**
+ * Writes one line per phase with the number of durations recorded and
+ * the mean, median, 95th and 99th percentile and maximum of the most
+ * recent ones, in milliseconds.  Phases with nothing recorded are left
+ * out.
+ */
+    void report(std::ostream& out) const;
+
+private:
+    struct PhaseSamples {
+        mutable std::mutex lock;
+        long long count;                 // durations recorded in total
+        std::vector<double> recent;      // the last kWindowSize durations
+        size_t next;                     // where the next one goes once recent is full
+    };
+
+    static const size_t kWindowSize = 512;
+
+    std::atomic<bool> enabled;
+    PhaseSamples phases[kNumPhases];
+
+    LifeTimings(const LifeTimings& original);
+    void operator=(const LifeTimings& rhs) const;
+};
+
+/**
+ * Times the rest of the enclosing scope as one run of a phase.  A null or
+ * switched off LifeTimings records nothing.
+ */
+class PhaseTimer {
+public:
+    PhaseTimer(LifeTimings* timings, LifePhase phase);
+    ~PhaseTimer();
+
+private:
+    LifeTimings* timings;             // null if nothing is being timed
+    LifePhase phase;
+    std::chrono::steady_clock::time_point start;
+
+    PhaseTimer(const PhaseTimer& original);
+    void operator=(const PhaseTimer& rhs) const;
+};
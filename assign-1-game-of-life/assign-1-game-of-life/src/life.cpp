@@ -4,13 +4,14 @@
  * Implements the Game of Life.
  */
 
+#include <chrono>    // for steady_clock
 #include <iostream>  // for cout
 #include <fstream>   // for file read
 
 using namespace std;
 
 #include "console.h" // required of all files that contain the main function
-#include "simpio.h"  // for getLine
+#include "simpio.h"  // for getLine, getYesOrNo
 #include "gevents.h" // for mouse event detection
 #include "gtimer.h"  // timer events
 #include "strlib.h"
@@ -20,29 +21,50 @@ using namespace std;
 
 #include "life-constants.h"  // for kMaxAge
 #include "life-graphics.h"   // for class LifeDisplay
+#include "life-engine.h"     // for class LifeEngine
+#include "life-hashlife.h"   // for class HashLifeEngine
+#include "life-parallel.h"   // for class ParallelLifeEngine
+#include "life-patterns.h"   // for fillRandomGrid, readPatternFile
+#include "life-args.h"       // for commandLineArgs
+#include "life-bench.h"      // for runBenchmark
+#include "life-soup.h"       // for runSoupSearch
+#include "life-regress.h"    // for runRegression
+#include "life-simulation.h" // for LifeSimulation, LifeFrame
+#include "life-timing.h"     // for LifeTimings, PhaseTimer
 
+/**
+ * Boards with more cells than this are drawn into a single pixel image
+ * rather than with one GOval per cell.
+ */
+static const int kMaxCellObjects = 10000;
 
-static void welcome();
+/**
+ * Milliseconds to wait before checking again when the simulation has no
+ * new frame to draw.
+ */
+static const int kIdleDelay = 5;
 
-int fillCell();
+/**
+ * Milliseconds between reports of the phase timings, when they are on.
+ */
+static const int kReportInterval = 2000;
 
-void createCopy(const Grid<int>& grid, Grid<int>& gridCopy);
 
-void initialize(Grid<int>& grid);
+static void welcome();
 
-int setSpeed();
+void initialize(Grid<int>& grid, LifeRule& rule);
 
-void printBoard(LifeDisplay& display, const Grid<int>& grid, Grid<int>& gridCopy, const int rows, const int cols);
+LifeEngine* chooseEngine(const LifeRule& patternRule);
 
-int countNeighbors(Grid<int>& grid, const int row, const int col);
+static void chooseViewport(LifeDisplay& display, const Grid<int>& grid);
 
-int nextGeneration(Grid<int>& grid, int neighbors, int row, int col);
+int setSpeed();
 
-void buildGridFromFile(Grid<int>& grid);
+void printBoard(LifeDisplay& display, const LifeFrame& frame, LifeTimings* timings);
 
-int setGridElement(string line, unsigned int index);
+static void reportTimings(const LifeTimings& timings, ofstream& statsFile, long long generation);
 
-void setNextGeneration(const Grid<int>& grid, Grid<int>& gridCopy, const int rows, const int cols);
+void buildGridFromFile(Grid<int>& grid, LifeRule& rule);
 
 /**
  * Function: main
@@ -50,32 +72,81 @@ void setNextGeneration(const Grid<int>& grid, Grid<int>& gridCopy, const int row
  * Provides the entry point of the entire program.
  */
 int main() {
+    Vector<string> args = commandLineArgs();
+    if (args.contains("--bench")) {
+        return runBenchmark(args);
+    }
+    if (args.contains("--soup")) {
+        return runSoupSearch(args);
+    }
+    if (args.contains("--regress")) {
+        return runRegression(args);
+    }
+
+    // --timings reports how long each phase of a generation takes every few
+    // seconds; --timings-file PATH appends the reports to a file instead
+    LifeTimings timings;
+    ofstream statsFile;
+    for (int i = 0; i < args.size(); i++) {
+        if (args[i] == "--timings") {
+            timings.setEnabled(true);
+        } else if (args[i] == "--timings-file" && i + 1 < args.size()) {
+            statsFile.open(args[++i].c_str(), ios::app);
+            if (statsFile.fail()) {
+                cout << "Error. Couldn't write " << args[i] << "." << endl;
+                return 1;
+            }
+            timings.setEnabled(true);
+        }
+    }
+
     LifeDisplay display;
     display.setTitle("Game of Life");
     Grid<int> board;
-    Grid<int> boardCopy;
+    LifeRule patternRule = kConwayRule;
     welcome();
-    initialize(board);
-    createCopy(board, boardCopy);
+    initialize(board, patternRule);
+    display.setPixelMode(board.size() > kMaxCellObjects);
+    chooseViewport(display, board);
+    LifeEngine* engine = chooseEngine(patternRule);
+    engine->load(board);
     int speed = setSpeed();
-    int rows = board.numRows();
-    int cols = board.numCols();
 
     cout << getLine("Press [enter] to start simulation.") << endl;
 
-    while(true) {
-
-        printBoard(display, board, boardCopy, rows, cols);
-
-        if (board.equals(boardCopy)) {
+    // the engine steps on its own thread; this one draws whatever frame is
+    // newest and otherwise just waits, so drawing never slows the colony down
+    LifeSimulation simulation(*engine, speed);
+    simulation.setTimings(&timings);
+    simulation.start();
+    LifeFrame frame;
+    frame.generation = 0;
+    chrono::steady_clock::time_point lastReport = chrono::steady_clock::now();
+    while (true) {
+        bool finished = simulation.finished();
+        if (timings.isEnabled() && chrono::steady_clock::now() - lastReport >= chrono::milliseconds(kReportInterval)) {
+            reportTimings(timings, statsFile, frame.generation);
+            lastReport = chrono::steady_clock::now();
+        }
+        if (simulation.takeFrame(frame)) {
+            printBoard(display, frame, &timings);
+            display.setTitle("Game of Life - generation " + to_string(frame.generation) +
+                             ", population " + to_string(frame.population) + frame.motion);
+        } else if (finished) {
             break;
+        } else {
+            pause(kIdleDelay);
         }
-
-        board = boardCopy;
-
-        pause(speed);
+    }
+    if (!simulation.message().empty()) {
+        cout << simulation.message() << endl;
+    }
+    if (timings.isEnabled()) {
+        reportTimings(timings, statsFile, frame.generation);
     }
 
+    simulation.stop();
+    delete engine;
     return 0;
 }
 
@@ -96,59 +167,100 @@ static void welcome() {
 }
 
 /**
-  * Function: fillCell
-  * ------------------
-  * Sets the value of grid cell
+  * Function: initialize
+  * --------------------
+  * Creates a new Grid object based on user input.  A pattern file that
+  * names its rule stores it in rule, which is otherwise left alone.
   */
-int fillCell() {
-    if(randomInteger(0,1) == 0){
-        return 0;
+void initialize(Grid<int>& grid, LifeRule& rule) {
+    cout << "Do you want to start with a random grid or upload your own?" << endl;
+    cout << "\t1. Press 1 for randomly generated." << endl;
+    cout << "\t2. Press 2 to upload your own." << endl;
+
+    int startChoice = getIntegerBetween("Press 1 or 2then [enter]:", 1, 2);
+
+    if (startChoice == 1) {
+        fillRandomGrid(grid, randomInteger(40,60), randomInteger(40,60));
     }
-    else {
-        return randomInteger(1, kMaxAge);
+    else if (startChoice == 2) {
+        buildGridFromFile(grid, rule);
     }
 }
 
 /**
-  * Function: createCopy
-  * -------------------
-  * Make copy of your grid
+  * Function: chooseEngine
+  * ----------------------
+  * Lets the user pick which engine steps the colony.  The rule defaults
+  * to the one the pattern was written for.
   */
-void createCopy(const Grid<int>& grid, Grid<int>& gridCopy) {
-    int rows = grid.numRows();
-    int cols = grid.numCols();
+LifeEngine* chooseEngine(const LifeRule& patternRule) {
+    Vector<string> names = lifeEngineNames();
+    cout << "Choose simulation engine:" << endl;
+    for (int i = 0; i < names.size(); ++i) {
+        cout << "\t" << (i + 1) << ". " << names[i] << endl;
+    }
 
-    gridCopy.resize(rows, cols);
+    int engineChoice = getIntegerBetween("Make selection then press [enter]: ", 1, names.size());
 
-    for (int i = 0; i < rows; i++) {
-        for (int j = 0; j < cols; j++) {
-            gridCopy.set(i,j,grid.get(i,j));
+    LifeEngine* engine = createLifeEngine(names[engineChoice - 1]);
+    HashLifeEngine* hashLife = dynamic_cast<HashLifeEngine*>(engine);
+    if (hashLife != nullptr) {
+        int exponent = getIntegerBetween("Generations per step, as a power of 2 (0-48): ", 0, 48);
+        hashLife->setStepExponent(exponent);
+    }
+    ParallelLifeEngine* parallel = dynamic_cast<ParallelLifeEngine*>(engine);
+    if (parallel != nullptr) {
+        int threads = getIntegerBetween("Number of threads (0 for one per core): ", 0, 256);
+        parallel->setThreadCount(threads);
+    }
+    while (true) {
+        string ruleText = getLine("Rule, e.g. B36/S23 or HighLife ([enter] for "
+                                  + string(patternRule == kConwayRule ? "Conway's " : "the pattern's ")
+                                  + lifeRuleString(patternRule) + "): ");
+        LifeRule rule = patternRule;
+        if (ruleText.empty() && !engine->setRule(rule)) {
+            cout << "The " << engine->name() << " engine can't simulate the pattern's rule "
+                 << lifeRuleString(rule) << ", so it runs under Conway's B3/S23." << endl;
+            engine->setRule(kConwayRule);
+            break;
+        } else if (!ruleText.empty() && !parseLifeRule(ruleText, rule)) {
+            cout << "That isn't a rule.  Rules look like B3/S23, with the neighbor counts" << endl;
+            cout << "that give birth after the B and those that let a cell survive after the S." << endl;
+        } else if (!engine->setRule(rule)) {
+            cout << "The " << engine->name() << " engine can't simulate " << lifeRuleString(rule) << "." << endl;
+        } else {
+            break;
         }
     }
+    if (getYesOrNo("Wrap around the edges of the board? (y/n) ")) {
+        if (!engine->setWrapping(true)) {
+            cout << "The " << engine->name() << " engine can't wrap around, so the edges stay bounded." << endl;
+        }
+    }
+    return engine;
 }
 
 /**
-  * Function: initialize
-  * --------------------
-  * Creates a new Grid object based on user input.
+  * Function: chooseViewport
+  * ------------------------
+  * Offers to show only part of a large board, zoomed in or out, so that
+  * drawing costs the same however big the board is.
   */
-void initialize(Grid<int>& grid) {
-    cout << "Do you want to start with a random grid or upload your own?" << endl;
-    cout << "\t1. Press 1 for randomly generated." << endl;
-    cout << "\t2. Press 2 to upload your own." << endl;
-
-    int startChoice = getIntegerBetween("Press 1 or 2then [enter]:", 1, 2);
-
-    if (startChoice == 1) {
-        grid.resize(randomInteger(40,60), randomInteger(40,60));
-        for(int r = 0; r < grid.numRows(); ++r) {
-            for(int c = 0; c < grid.numCols(); ++c) {
-                grid.set(r,c,fillCell());
-            }
-        }
+static void chooseViewport(LifeDisplay& display, const Grid<int>& grid) {
+    if (grid.size() <= kMaxCellObjects) {
+        return;
     }
-    else if (startChoice == 2) {
-        buildGridFromFile(grid);
+    while (true) {
+        string zoomText = getLine("Zoom in pixels per cell, e.g. 4 or 0.25 ([enter] to fit the whole board): ");
+        if (zoomText.empty()) {
+            return;
+        }
+        if (stringIsReal(zoomText) && stringToReal(zoomText) > 0) {
+            display.setViewport(grid.numRows() / 2, grid.numCols() / 2, stringToReal(zoomText));
+            cout << "Use the arrow keys to pan and + and - to zoom." << endl;
+            return;
+        }
+        cout << "The zoom must be a positive number." << endl;
     }
 }
 
@@ -163,8 +275,9 @@ int setSpeed() {
     cout << "\t2. Medium" << endl;
     cout << "\t3. Slow" << endl;
     cout << "\t4. Manual input" << endl;
+    cout << "\t5. As fast as possible" << endl;
 
-    int speedChoice = getIntegerBetween("Make selection then press [enter]: ", 1,4);
+    int speedChoice = getIntegerBetween("Make selection then press [enter]: ", 1,5);
 
     switch(speedChoice) {
         case 1:
@@ -179,6 +292,9 @@ int setSpeed() {
         case 4:
                 speedChoice = getInteger("Enter time(ms): ");
                 break;
+        case 5:
+                speedChoice = 0;
+                break;
     }
 
     return speedChoice;
@@ -189,144 +305,57 @@ int setSpeed() {
  * --------------------
  * Displays board on screen
  */
-void printBoard(LifeDisplay& display, const Grid<int>& grid, Grid<int>& gridCopy, const int rows, const int cols) {
-
-    display.setDimensions(rows, cols);
-
-    for(int i = 0; i < rows; ++i) {
-        for(int j = 0; j < cols; ++j) {
-            display.drawCellAt(i, j, grid.get(i,j));
-        }
+void printBoard(LifeDisplay& display, const LifeFrame& frame, LifeTimings* timings) {
+    display.setDimensions(frame.rows, frame.cols);
+    {
+        PhaseTimer timer(timings, kDrawPhase);
+        display.drawBoard(frame.ages);
+    }
+    {
+        PhaseTimer timer(timings, kRepaintPhase);
+        display.repaint();
     }
-
-    display.repaint();
-
-    setNextGeneration(grid, gridCopy, rows, cols);
 
     // display.printBoard();
 }
 
 /**
-  * Function: countNeighbors
-  * ------------------------
-  * count number of element's neighbors
-  */
-int countNeighbors(const Grid<int>& grid, const int row, const int col) {
-    int neighbors = 0;
-    for (int i = row-1; i < row+2; ++i) {
-        for (int j = col-1; j < col+2; ++j) {
-            if (grid.inBounds(i, j)) {
-                if (grid.get(i,j) > 0) {
-                    if (i == row && j == col) {
-                        neighbors += 0;
-                    }
-                    else {
-                        ++neighbors;
-                    }
-                }
-            }
-        }
-    }
-    return neighbors;
-}
-
-/**
- * @brief nextGeneration
- * @param grid
- * @param neighbors
- * @param row
- * @param col
- * @return
- * ----------------------
- * returns value of cell's next generation
+ * Writes the phase timings so far to the stats file if one was given,
+ * or to the console otherwise.
  */
-int nextGeneration(Grid<int>& grid, int neighbors, int row, int col) {
-    int next;
-    switch(neighbors) {
-        case 2:
-                next = grid.get(row, col);
-                break;
-        case 3:
-                next = (grid.get(row,col) +1);
-                break;
-        default:
-                next = 0;
-                break;
-    }
-    return next;
+static void reportTimings(const LifeTimings& timings, ofstream& statsFile, long long generation) {
+    ostream& out = statsFile.is_open() ? statsFile : cout;
+    out << "Timings at generation " << generation << ":" << endl;
+    timings.report(out);
+    out << endl;
 }
 
 /**
  * @brief buildGridFromFile
  * @param grid
- * Creates a grid based on a file
+ * @param rule
+ * Creates a grid based on a file in plaintext, RLE or Life 1.06 format,
+ * and stores the rule the file names, if any, in rule.  The cells go
+ * straight into the grid as the file is read, and only the pattern's
+ * size is echoed, so large files load quickly.
  */
-void buildGridFromFile(Grid<int>& grid) {
-    ifstream input;
-    input.open("Colony.txt");
-    if (input.fail()) {
-        cout << "Error. Couldn't open file." << endl;
+void buildGridFromFile(Grid<int>& grid, LifeRule& rule) {
+    string fileName = getLine("Enter a file name, e.g. files/Glider Gun ([enter] for Colony.txt): ");
+    if (fileName.empty()) {
+        fileName = "Colony.txt";
     }
-    else {
-        string line;
-        int linePos = 0;
-        int rows = 0;
-        int cols = 0;
-        while(getline(input, line)) {
-            if (linePos <= 1) {
-                switch(linePos) {
-                    case 0:
-                            rows = stringToInteger(line);
-                            break;
-                    case 1: cols = stringToInteger(line);
-                            break;
-                }
-                cout << line << endl;
-                if (linePos == 1) {
-                    grid.resize(rows, cols);
-                }
-            }
-            else {
-                for(unsigned int i = 0; i < line.length(); ++i) {
-                    cout << line[i];
-                    grid.set(linePos-2, int(i), setGridElement(line, i));
-                }
-                cout << endl;
-            }
-            ++linePos;
-        }
+    LifePattern pattern;
+    GridCellSink sink(grid);
+    if (!readPatternFile(fileName, pattern, sink)) {
+        grid.resize(0, 0);
+        cout << "Error. Couldn't read pattern file." << endl;
+        return;
     }
-    input.close();
-}
-/**
- * @brief setGridElement
- * @param line
- * @param index
- * @return
- * Sets grid's element value from file
- */
-int setGridElement(string line, unsigned int index) {
-    if (line[index] == 45) {
-        return 0;
-    }
-    else {
-        return randomInteger(1, kMaxAge);
-    }
-}
-
-/**
- * @brief setNextGeneration
- * @param grid
- * @param gridCopy
- * @param rows
- * @param cols
- * Iterate through grid and set it's next generation value.
- */
-void setNextGeneration(const Grid<int>& grid, Grid<int>& gridCopy, const int rows, const int cols) {
-    for (int i = 0; i < rows; ++i) {
-        for (int j = 0; j < cols; ++j) {
-            gridCopy.set(i,j,nextGeneration(gridCopy, countNeighbors(grid, i, j), i, j));
+    cout << pattern.rows << "x" << pattern.cols << " with " << pattern.population << " live cells" << endl;
+    if (pattern.hasRule) {
+        rule = pattern.rule;
+        if (rule != kConwayRule) {
+            cout << "The pattern was written for " << lifeRuleString(rule) << ", which it will run under." << endl;
         }
     }
 }
-
@@ -0,0 +1,201 @@
+/**
+ * File: word-ladder-batch.cpp
+ * ---------------------------
+ * Implements the batch mode.  Workers take queries from a shared counter,
+ * so long and short searches even out across threads, and each worker
+ * keeps its own LadderSearch so that nothing but the read-only index is
+ * shared.  The ladders are written in query order once every query is done.
+ */
+
+#include <algorithm>  // for max, sort
+#include <atomic>     // for atomic
+#include <chrono>     // for steady_clock
+#include <fstream>    // for ifstream, ofstream
+#include <iomanip>    // for setprecision
+#include <iostream>   // for cout
+#include <sstream>    // for istringstream
+#include <thread>     // for thread
+#include <vector>     // for vector
+using namespace std;
+#include "console.h"  // for setConsoleEcho
+#include "qtgui.h"    // for QtGui
+#include "strlib.h"   // for stringIsInteger, stringToInteger, toLowerCase, trim
+
+#include "word-ladder-batch.h"
+#include "word-ladder-search.h"
+
+/**
+ * One query and its answer.
+ */
+struct LadderQuery {
+    string start;
+    string end;
+    bool known;           // false if either word is not in the dictionary
+    vector<int> ladder;   // empty if there is no ladder
+    double seconds;
+};
+
+static bool readQueries(const string& fileName, vector<LadderQuery>& queries);
+static void solveQueries(const WordIndex& index, atomic<size_t>& nextQuery, vector<LadderQuery>& queries);
+static double percentile(const vector<double>& sorted, double fraction);
+static void printUsage();
+
+Vector<string> commandLineArgs() {
+    Vector<string> args;
+    int argc = QtGui::instance()->getArgc();
+    char** argv = QtGui::instance()->getArgv();
+    for (int i = 1; i < argc; i++) {
+        args.add(argv[i]);
+    }
+    return args;
+}
+
+int runBatch(const WordIndex& index, const Vector<string>& args) {
+    setConsoleEcho(true);
+
+    string queryName;
+    string outputName = "ladders.txt";
+    int threads = 0;
+    for (int i = 0; i < args.size(); i++) {
+        bool hasValue = i + 1 < args.size();
+        if (args[i] == "--batch") {
+            continue;
+        } else if (args[i] == "--queries" && hasValue) {
+            queryName = args[++i];
+        } else if (args[i] == "--output" && hasValue) {
+            outputName = args[++i];
+        } else if (args[i] == "--threads" && hasValue && stringIsInteger(args[i + 1])) {
+            threads = stringToInteger(args[++i]);
+        } else {
+            printUsage();
+            return 1;
+        }
+    }
+    if (queryName.empty()) {
+        printUsage();
+        return 1;
+    }
+    if (threads <= 0) {
+        threads = max(1, static_cast<int>(thread::hardware_concurrency()));
+    }
+
+    vector<LadderQuery> queries;
+    if (!readQueries(queryName, queries)) {
+        cout << "Error. Couldn't read queries from " << queryName << "." << endl;
+        return 1;
+    }
+    ofstream output(outputName.c_str());
+    if (output.fail()) {
+        cout << "Error. Couldn't write " << outputName << "." << endl;
+        return 1;
+    }
+
+    atomic<size_t> nextQuery(0);
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    vector<thread> workers;
+    for (int id = 1; id < threads; id++) {
+        workers.push_back(thread(solveQueries, cref(index), ref(nextQuery), ref(queries)));
+    }
+    solveQueries(index, nextQuery, queries);
+    for (size_t i = 0; i < workers.size(); i++) {
+        workers[i].join();
+    }
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+    vector<double> latencies;
+    int found = 0;
+    for (size_t i = 0; i < queries.size(); i++) {
+        const LadderQuery& query = queries[i];
+        output << query.start << " " << query.end << ":";
+        if (!query.known) {
+            output << " not a word";
+        } else if (query.ladder.empty()) {
+            output << " no ladder";
+        } else {
+            for (size_t l = 0; l < query.ladder.size(); l++) {
+                output << " " << index.wordAt(query.ladder[l]);
+            }
+            found++;
+        }
+        output << '\n';
+        latencies.push_back(query.seconds);
+    }
+    output.close();
+    if (output.fail()) {
+        cout << "Error. Couldn't write " << outputName << "." << endl;
+        return 1;
+    }
+
+    sort(latencies.begin(), latencies.end());
+    cout << fixed << setprecision(3);
+    cout << "queries:         " << queries.size() << " on " << threads << " threads, "
+         << found << " with a ladder" << endl;
+    cout << "run time:        " << seconds << " s" << endl;
+    cout << "queries/sec:     " << queries.size() / seconds << endl;
+    if (!latencies.empty()) {
+        cout << "latency p50:     " << percentile(latencies, 0.50) * 1e6 << " us" << endl;
+        cout << "latency p90:     " << percentile(latencies, 0.90) * 1e6 << " us" << endl;
+        cout << "latency p99:     " << percentile(latencies, 0.99) * 1e6 << " us" << endl;
+        cout << "latency max:     " << latencies.back() * 1e6 << " us" << endl;
+    }
+    cout << "ladders:         " << outputName << endl;
+    return 0;
+}
+
+/**
+ * Reads one query per line, lowercasing the words.  Returns false if the
+ * file can't be opened or a line doesn't hold two words.
+ */
+static bool readQueries(const string& fileName, vector<LadderQuery>& queries) {
+    ifstream input(fileName.c_str());
+    if (input.fail()) {
+        return false;
+    }
+    string line;
+    while (getline(input, line)) {
+        line = trim(line);
+        if (line.empty() || line[0] == '#') {
+            continue;
+        }
+        istringstream words(toLowerCase(line));
+        LadderQuery query;
+        if (!(words >> query.start >> query.end)) {
+            return false;
+        }
+        query.known = false;
+        query.seconds = 0;
+        queries.push_back(query);
+    }
+    return true;
+}
+
+/**
+ * Body of each worker: answers queries until the counter passes the last
+ * one, timing each of them.
+ */
+static void solveQueries(const WordIndex& index, atomic<size_t>& nextQuery, vector<LadderQuery>& queries) {
+    LadderSearch search(index);
+    size_t i;
+    while ((i = nextQuery++) < queries.size()) {
+        LadderQuery& query = queries[i];
+        chrono::steady_clock::time_point start = chrono::steady_clock::now();
+        int from = index.idOf(query.start);
+        int to = index.idOf(query.end);
+        query.known = from >= 0 && to >= 0;
+        if (query.known) {
+            search.findLadder(from, to, query.ladder);
+        }
+        query.seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    }
+}
+
+/**
+ * Returns the given fraction's nearest-rank percentile of sorted values.
+ */
+static double percentile(const vector<double>& sorted, double fraction) {
+    return sorted[static_cast<size_t>(fraction * (sorted.size() - 1) + 0.5)];
+}
+
+static void printUsage() {
+    cout << "Usage: word-ladder --batch --queries PATH [--output PATH] [--threads N]" << endl;
+}
@@ -0,0 +1,37 @@
+/**
+ * File: word-ladder-batch.h
+ * -------------------------
+ * Defines the batch mode of the word ladder program.  It solves a whole
+ * file of queries in one process, reusing the loaded dictionary and its
+ * neighbor index, spreads the queries across all cores and reports how
+ * quickly they were answered.
+ */
+
+#pragma once
+#include <string>    // for std::string
+#include "vector.h"  // for Vector
+
+#include "word-ladder-index.h"
+
+/**
+ * Returns the arguments the program was started with, not counting the
+ * program name.
+ */
+Vector<std::string> commandLineArgs();
+
+/**
+ * Runs the batch described by args against the index and returns the exit
+ * status.  Recognized arguments:
+ *
+ *   --batch                  select this mode
+ *   --queries PATH           file with one "start end" pair per line (required)
+ *   --output PATH            where to write the ladders (default ladders.txt)
+ *   --threads N              worker threads (default one per core)
+ *
+ * Blank lines and lines starting with '#' in the query file are skipped.
+ * The output has one line per query, in query order: the two words, a
+ * colon and then the ladder, "no ladder", or "not a word".  The number of
+ * queries, queries/sec and the median, 90th, 99th percentile and maximum
+ * latency of a query are printed to the console.
+ */
+int runBatch(const WordIndex& index, const Vector<std::string>& args);
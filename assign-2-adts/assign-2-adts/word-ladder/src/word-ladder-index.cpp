@@ -0,0 +1,105 @@
+/**
+ * File: word-ladder-index.cpp
+ * ---------------------------
+ * Implements the neighbor index.  Words of one length are sorted once per
+ * letter position with that position left out of the comparison, which
+ * brings each group of words matching a wildcard pattern such as "c*t"
+ * together without building the patterns themselves.
+ */
+
+#include <algorithm>  // for sort, lower_bound, is_sorted
+using namespace std;
+
+#include "word-ladder-index.h"
+
+/**
+ * Compares two word numbers by their words with the letter at position
+ * left out.  Words that compare equal differ at most at that position.
+ */
+struct WildcardLess {
+    const vector<string>* words;
+    size_t position;
+
+    bool operator()(int a, int b) const {
+        const string& first = (*words)[a];
+        const string& second = (*words)[b];
+        int head = first.compare(0, position, second, 0, position);
+        if (head != 0) {
+            return head < 0;
+        }
+        return first.compare(position + 1, string::npos, second, position + 1, string::npos) < 0;
+    }
+};
+
+WordIndex::WordIndex(const Lexicon& english) {
+    for (string word : english) {
+        words.push_back(word);
+    }
+    if (!is_sorted(words.begin(), words.end())) {
+        sort(words.begin(), words.end());
+    }
+    adjacent.resize(words.size());
+
+    vector<vector<int> > byLength;
+    for (size_t id = 0; id < words.size(); id++) {
+        size_t length = words[id].length();
+        if (length >= byLength.size()) {
+            byLength.resize(length + 1);
+        }
+        byLength[length].push_back(static_cast<int>(id));
+    }
+    for (size_t length = 1; length < byLength.size(); length++) {
+        for (size_t position = 0; position < length; position++) {
+            linkPosition(byLength[length], position);
+        }
+    }
+    for (size_t id = 0; id < adjacent.size(); id++) {
+        sort(adjacent[id].begin(), adjacent[id].end());
+    }
+}
+
+int WordIndex::size() const {
+    return static_cast<int>(words.size());
+}
+
+int WordIndex::idOf(const string& word) const {
+    vector<string>::const_iterator found = lower_bound(words.begin(), words.end(), word);
+    if (found == words.end() || *found != word) {
+        return -1;
+    }
+    return static_cast<int>(found - words.begin());
+}
+
+const string& WordIndex::wordAt(int id) const {
+    return words[id];
+}
+
+const vector<int>& WordIndex::neighbors(int id) const {
+    return adjacent[id];
+}
+
+/**
+ * Sorts a group of words of one length by their wildcard pattern at the
+ * given position and links every pair of words sharing a pattern.  Two
+ * different words share a pattern at no more than one position, so no
+ * link is added twice.
+ */
+void WordIndex::linkPosition(vector<int>& group, size_t position) {
+    WildcardLess less = { &words, position };
+    sort(group.begin(), group.end(), less);
+    size_t start = 0;
+    while (start < group.size()) {
+        size_t stop = start + 1;
+        while (stop < group.size() && !less(group[start], group[stop])) {
+            stop++;
+        }
+        for (size_t i = start; i < stop; i++) {
+            for (size_t j = start; j < stop; j++) {
+                if (i != j) {
+                    adjacent[group[i]].push_back(group[j]);
+                }
+            }
+        }
+        start = stop;
+    }
+}
@@ -0,0 +1,51 @@
+/**
+ * File: word-ladder-index.h
+ * -------------------------
+ * Defines an index of which dictionary words are one letter apart.  It is
+ * built once when the dictionary is loaded, so that a ladder search can
+ * walk a word's list of neighbors instead of probing the lexicon with
+ * every one-letter variant of the word.
+ */
+
+#pragma once
+#include <string>   // for std::string
+#include <vector>   // for std::vector
+#include "lexicon.h"
+
+class WordIndex {
+public:
+/**
+ * Numbers the words of the lexicon in alphabetical order and links every
+ * pair of words of the same length that differ in exactly one letter.
+ */
+    explicit WordIndex(const Lexicon& english);
+
+/**
+ * Returns the number of words in the index.
+ */
+    int size() const;
+
+/**
+ * Returns the number of the given word, or -1 if it is not in the index.
+ */
+    int idOf(const std::string& word) const;
+
+/**
+ * Returns the word with the given number.
+ */
+    const std::string& wordAt(int id) const;
+
+/**
+ * Returns the numbers of the words one letter away from the given word.
+ */
+    const std::vector<int>& neighbors(int id) const;
+
+private:
+    std::vector<std::string> words;             // alphabetical, so idOf can search it
+    std::vector<std::vector<int> > adjacent;    // adjacent[id] lists the neighbors of words[id]
+
+    void linkPosition(std::vector<int>& group, size_t position);
+
+    WordIndex(const WordIndex& original);
+    void operator=(const WordIndex& rhs) const;
+};
@@ -0,0 +1,83 @@
+/**
+ * File: word-ladder-search.cpp
+ * ----------------------------
+ * Implements the ladder search.  Side 0 searches from the start word and
+ * side 1 from the end word, a whole level at a time, always expanding
+ * whichever frontier is smaller.  The first word both sides reach lies on
+ * a shortest ladder.
+ */
+
+#include <algorithm>  // for fill, reverse
+using namespace std;
+
+#include "word-ladder-search.h"
+
+LadderSearch::LadderSearch(const WordIndex& index) : index(index) {
+    for (int side = 0; side < 2; side++) {
+        parent[side].resize(index.size());
+        visited[side].resize((index.size() + 63) / 64);
+    }
+}
+
+bool LadderSearch::findLadder(int start, int end, vector<int>& ladder) {
+    ladder.clear();
+    for (int side = 0; side < 2; side++) {
+        fill(visited[side].begin(), visited[side].end(), 0);
+        frontier[side].clear();
+    }
+    markVisited(0, start, -1);
+    markVisited(1, end, -1);
+    frontier[0].push_back(start);
+    frontier[1].push_back(end);
+
+    int meeting = (start == end) ? start : -1;
+    while (meeting < 0 && !frontier[0].empty() && !frontier[1].empty()) {
+        meeting = expand((frontier[0].size() <= frontier[1].size()) ? 0 : 1);
+    }
+    if (meeting < 0) {
+        return false;
+    }
+
+    for (int id = meeting; id >= 0; id = parent[0][id]) {
+        ladder.push_back(id);
+    }
+    reverse(ladder.begin(), ladder.end());
+    for (int id = parent[1][meeting]; id >= 0; id = parent[1][id]) {
+        ladder.push_back(id);
+    }
+    return true;
+}
+
+/**
+ * Expands every word in one side's frontier by one step and replaces the
+ * frontier with the words newly reached.  Returns the first new word the
+ * other side has already reached, or -1 if the sides have not met yet.
+ */
+int LadderSearch::expand(int side) {
+    reached.clear();
+    const vector<int>& words = frontier[side];
+    for (size_t f = 0; f < words.size(); f++) {
+        const vector<int>& next = index.neighbors(words[f]);
+        for (size_t i = 0; i < next.size(); i++) {
+            int id = next[i];
+            if (!isVisited(side, id)) {
+                markVisited(side, id, words[f]);
+                if (isVisited(1 - side, id)) {
+                    return id;
+                }
+                reached.push_back(id);
+            }
+        }
+    }
+    frontier[side].swap(reached);
+    return -1;
+}
+
+bool LadderSearch::isVisited(int side, int id) const {
+    return (visited[side][id / 64] >> (id % 64)) & 1;
+}
+
+void LadderSearch::markVisited(int side, int id, int from) {
+    visited[side][id / 64] |= 1ULL << (id % 64);
+    parent[side][id] = from;
+}
@@ -0,0 +1,45 @@
+/**
+ * File: word-ladder-search.h
+ * --------------------------
+ * Defines the search for shortest word ladders.  Words are handled by
+ * their numbers in a WordIndex, and the search keeps one parent number and
+ * one visited bit per word for each end, so nothing is copied while
+ * searching and the ladder itself is only built once the ends meet.
+ */
+
+#pragma once
+#include <cstdint>  // for uint64_t
+#include <vector>   // for std::vector
+
+#include "word-ladder-index.h"
+
+class LadderSearch {
+public:
+/**
+ * Prepares to search the given index, which must outlive the search.
+ * The working storage is allocated once here and reused by every search,
+ * so a thread that runs many searches should keep one LadderSearch.
+ */
+    explicit LadderSearch(const WordIndex& index);
+
+/**
+ * Fills ladder with the numbers of the words on a shortest ladder from
+ * start to end, both included, and returns true, or returns false if the
+ * words are not connected.  Both must be numbers of words in the index.
+ */
+    bool findLadder(int start, int end, std::vector<int>& ladder);
+
+private:
+    const WordIndex& index;
+    std::vector<int> parent[2];              // word each word was reached from, from start and from end
+    std::vector<std::uint64_t> visited[2];   // one bit per word reached from start and from end
+    std::vector<int> frontier[2];            // words reached in the latest level from each end
+    std::vector<int> reached;                // scratch for the next level
+
+    int expand(int side);
+    bool isVisited(int side, int id) const;
+    void markVisited(int side, int id, int from);
+
+    LadderSearch(const LadderSearch& original);
+    void operator=(const LadderSearch& rhs) const;
+};
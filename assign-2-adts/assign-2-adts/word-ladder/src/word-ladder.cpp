@@ -12,9 +12,12 @@ using namespace std;
 #include "strlib.h"
 #include "simpio.h"
 #include "vector.h"
-#include "queue.h"
 #include "stack.h"
 
+#include "word-ladder-batch.h"
+#include "word-ladder-index.h"
+#include "word-ladder-search.h"
+
 void cycleWords(const Lexicon& english, const string& start);
 
 void printVect(const Vector<string>& vec);
@@ -27,65 +30,40 @@ static string getWord(const Lexicon& english, const string& prompt) {
     }
 }
 
-static void generateLadder(const Lexicon& english, const string& start, const string& end) {
+static void generateLadder(const WordIndex& index, LadderSearch& search, const string& start, const string& end) {
     cout << "Here's where you'll search for a word ladder connecting \"" << start << "\" to \"" << end << "\"." << endl;
-    // Queue<Stack <string>> Q;
-    Queue<Vector <string>> Q;
-    // Stack<string> ladder;
-    Vector<string> ladder;
-    Vector<string> wordTracker;
-    Vector<string> partial;
-    ladder.add(start);
-    wordTracker.add(start);
-    Q.enqueue(ladder);
-
-    while (!Q.isEmpty()) {
-        ladder = Q.dequeue();
-        if (ladder.get(ladder.size()-1) == end) {
-            cout << "Ladder: ";
-            for (int l = 0; l < ladder.size(); ++l) {
-                cout << ladder[l] << " ";
-            }
-            cout << endl;
-            break;
-        }
-        else {
-            string root = ladder.get(ladder.size()-1);
-            string newStr = root;
-            for (unsigned int i = 0; i < root.length(); ++i) {
-                for (int j = 0; j <= 26; ++j) {
-                    newStr[i] = (root[i] - 97 + j) % 26 + 97;
-                    if (english.contains(newStr) && !wordTracker.contains(newStr)) {
-                        // Create copy of partial ladder
-                        partial = ladder;
-                        // Push new word onto top of partial ladder copy
-                        partial.add(newStr);
-                        wordTracker.add(newStr);
-                        // cout << "Ladder: " << partial << endl;
-                        // Enqueue copy at end of queue
-                        Q.enqueue(partial);
-                        // cout << "Queue: " << Q << endl;
-                        // cout << "Found " << newStr << " in dictionary!" << endl;
-                    }
-                }
-            }
+    vector<int> ladder;
+    if (search.findLadder(index.idOf(start), index.idOf(end), ladder)) {
+        cout << "Ladder: ";
+        for (size_t l = 0; l < ladder.size(); ++l) {
+            cout << index.wordAt(ladder[l]) << " ";
         }
+        cout << endl;
     }
 }
 
 static const string kEnglishLanguageDatafile = "dictionary.txt";
 static void playWordLadder() {
     Lexicon english(kEnglishLanguageDatafile);
+    WordIndex index(english);
+    LadderSearch search(index);
     while (true) {
         string start = getWord(english, "Please enter the source word [return to quit]: ");
         if (start.empty()) break;
         string end = getWord(english, "Please enter the destination word [return to quit]: ");
         if (end.empty()) break;
-        generateLadder(english, start, end);
+        generateLadder(index, search, start, end);
     }
 }
 
 int main() {
+    Vector<string> args = commandLineArgs();
+    if (args.contains("--batch")) {
+        Lexicon english(kEnglishLanguageDatafile);
+        WordIndex index(english);
+        return runBatch(index, args);
+    }
+
     cout << "Welcome to the CS106 word ladder application!" << endl << endl;
     playWordLadder();
     cout << "Thanks for playing!" << endl;